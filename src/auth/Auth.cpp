@@ -21,9 +21,16 @@
 #include "Auth.h"
 #include "Constants.h"
 #include "AuthMessages.h"
-#include "SafeDataStream.h"
-
+#include "AuthWire.h"
+#include "EnvironmentTemplate.h"
+#include "FramedChannel.h"
+#include "HelperProcess.h"
+#include "HelperZygote.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
 #include <QtCore/QProcess>
+#include <QtCore/QTimer>
 #include <QtCore/QUuid>
 #include <QtNetwork/QLocalServer>
 #include <QtNetwork/QLocalSocket>
@@ -32,8 +39,14 @@
 
 #include <memory>
 
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
+// time a helper has to introduce itself after connecting, in milliseconds
+#define HANDSHAKE_TIMEOUT 30000
+
 namespace SDDM {
     class Auth::SocketServer : public QLocalServer {
         Q_OBJECT
@@ -52,22 +65,29 @@ namespace SDDM {
     public:
         Private(Auth *parent);
         ~Private();
-        void setSocket(QLocalSocket *socket);
+        void setChannel(FramedChannel *channel);
+        void adopt(HelperProcess *process, QLocalSocket *socket);
     public slots:
-        void dataPending();
+        void dataPending(const QByteArray &data);
+        void channelTimedOut();
         void childExited(int exitCode, QProcess::ExitStatus exitStatus);
         void childError(QProcess::ProcessError error);
         void requestFinished();
     public:
+        void send(const QByteArray &data);
+
         AuthRequest *request { nullptr };
-        QProcess *child { nullptr };
-        QLocalSocket *socket { nullptr };
+        HelperProcess *child { nullptr };
+        QPointer<FramedChannel> channel;
+        QPointer<HelperZygote> zygote;
+        QElapsedTimer startTimer;
         QString displayServerCmd;
         QString sessionPath { };
         QString user { };
         QString cookie { };
         bool autologin { false };
         bool greeter { false };
+        bool registered { false };
         QProcessEnvironment environment { };
         qint64 sessionPid { -1 };
         qint64 id { 0 };
@@ -85,17 +105,39 @@ namespace SDDM {
 
     void Auth::SocketServer::handleNewConnection()  {
         while (hasPendingConnections()) {
-            Msg m = Msg::MSG_UNKNOWN;
-            qint64 id;
             QLocalSocket *socket = nextPendingConnection();
-            SafeDataStream str(socket);
-            str.receive();
-            str >> m >> id;
-            if (m == Msg::HELLO && id && SocketServer::instance()->helpers.contains(id)) {
-                helpers[id]->setSocket(socket);
-                if (socket->bytesAvailable() > 0)
-                    helpers[id]->dataPending();
-            }
+            FramedChannel *channel = new FramedChannel(socket, socket);
+            connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+            connect(channel, &FramedChannel::timedOut, socket, &QLocalSocket::abort);
+
+            // the channel only times out frames that have been started,
+            // a connection that never sends anything is dropped here
+            QTimer *handshake = new QTimer(socket);
+            handshake->setSingleShot(true);
+            connect(handshake, &QTimer::timeout, socket, [socket]() {
+                qWarning() << "Auth: Connection to the helper socket didn't identify itself";
+                socket->abort();
+            });
+            handshake->start(HANDSHAKE_TIMEOUT);
+
+            // the helper introduces itself before anything else
+            auto hello = std::make_shared<QMetaObject::Connection>();
+            *hello = connect(channel, &FramedChannel::frameReceived, this, [this, socket, channel, hello, handshake](const QByteArray &data) {
+                disconnect(*hello);
+                handshake->stop();
+                handshake->deleteLater();
+
+                qint64 id = 0;
+                WireReader str(data);
+                str >> id;
+                if (str.isValid() && str.message() == Msg::HELLO && id && helpers.contains(id)) {
+                    disconnect(channel, &FramedChannel::timedOut, socket, &QLocalSocket::abort);
+                    helpers[id]->setChannel(channel);
+                } else {
+                    qWarning() << "Auth: Unexpected connection to the helper socket";
+                    socket->abort();
+                }
+            });
         }
     }
 
@@ -112,27 +154,9 @@ namespace SDDM {
     Auth::Private::Private(Auth *parent)
             : QObject(parent)
             , request(new AuthRequest(parent))
-            , child(new QProcess(this))
+            , child(new HelperProcess(this))
             , id(lastId++) {
-        SocketServer::instance()->helpers[id] = this;
-        QProcessEnvironment env = child->processEnvironment();
-        bool langEmpty = true;
-        QFile localeFile(QStringLiteral("/etc/locale.conf"));
-        if (localeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream in(&localeFile);
-            while (!in.atEnd()) {
-                QStringList parts = in.readLine().split(QLatin1Char('='));
-                if (parts.size() >= 2) {
-                    env.insert(parts[0], parts[1]);
-                    if (parts[0] == QLatin1String("LANG"))
-                        langEmpty = false;
-                }
-            }
-            localeFile.close();
-        }
-        if (langEmpty)
-            env.insert(QStringLiteral("LANG"), QStringLiteral("C"));
-        child->setProcessEnvironment(env);
+        child->setProcessEnvironment(EnvironmentTemplate::locale());
         connect(child, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, &Auth::Private::childExited);
         connect(child, QOverload<QProcess::ProcessError>::of(&QProcess::error), this, &Auth::Private::childError);
         connect(request, &AuthRequest::finished, this, &Auth::Private::requestFinished);
@@ -141,22 +165,61 @@ namespace SDDM {
 
     Auth::Private::~Private()
     {
-        SocketServer::instance()->helpers.remove(id);
+        if (registered)
+            SocketServer::instance()->helpers.remove(id);
     }
 
 
-    void Auth::Private::setSocket(QLocalSocket *socket) {
-        this->socket = socket;
-        connect(socket, &QLocalSocket::readyRead, this, &Auth::Private::dataPending);
+    void Auth::Private::setChannel(FramedChannel *channel) {
+        // whatever was left over from the last helper
+        if (this->channel && this->channel->device()->parent() == this)
+            this->channel->device()->deleteLater();
+
+        this->channel = channel;
+        connect(channel, &FramedChannel::frameReceived, this, &Auth::Private::dataPending);
+        connect(channel, &FramedChannel::timedOut, this, &Auth::Private::channelTimedOut);
+    }
+
+    void Auth::Private::adopt(HelperProcess *process, QLocalSocket *socket) {
+        child->disconnect(this);
+        child->deleteLater();
+
+        child = process;
+        child->setParent(this);
+        connect(child, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, &Auth::Private::childExited);
+        connect(child, QOverload<QProcess::ProcessError>::of(&QProcess::error), this, &Auth::Private::childError);
+
+        socket->setParent(this);
+        FramedChannel *channel = new FramedChannel(socket, socket);
+        channel->setPacketMode(true);
+        setChannel(channel);
     }
 
-    void Auth::Private::dataPending() {
+    void Auth::Private::send(const QByteArray &data) {
+        if (!channel) {
+            qCritical() << "Auth: sddm-helper is not connected, dropping message";
+            return;
+        }
+        channel->send(data);
+    }
+
+    void Auth::Private::channelTimedOut() {
+        qCritical() << "Auth: sddm-helper did not complete a message in time";
+        Q_EMIT qobject_cast<Auth*>(parent())->error(QStringLiteral("Auth: sddm-helper stopped responding"), ERROR_INTERNAL);
+
+        // the helper notices the closed socket and exits
+        if (channel)
+            channel->device()->close();
+    }
+
+    void Auth::Private::dataPending(const QByteArray &data) {
         Auth *auth = qobject_cast<Auth*>(parent());
-        Msg m = MSG_UNKNOWN;
-        SafeDataStream str(socket);
-        str.receive();
-        str >> m;
-        switch (m) {
+        WireReader str(data);
+        if (!str.isValid()) {
+            Q_EMIT auth->error(QStringLiteral("Auth: Malformed message received from sddm-helper"), ERROR_INTERNAL);
+            return;
+        }
+        switch (str.message()) {
             case ERROR: {
                 QString message;
                 Error type = ERROR_NONE;
@@ -183,9 +246,11 @@ namespace SDDM {
                 if (!user.isEmpty()) {
                     auth->setUser(user);
                     Q_EMIT auth->authentication(user, true);
-                    str.reset();
-                    str << AUTHENTICATED << environment << cookie;
-                    str.send();
+                    // the helper has been started with child's environment
+                    WireWriter out(AUTHENTICATED);
+                    out.writeEnvironment(environment, child->processEnvironment());
+                    out << cookie;
+                    send(out.data());
                 }
                 else {
                     Q_EMIT auth->authentication(user, false);
@@ -197,23 +262,20 @@ namespace SDDM {
                 qint64 pid; //not pid_t as we need to define the wire type
                 str >> status >> pid;
                 sessionPid = pid;
+                qDebug() << "Auth: Session started" << startTimer.elapsed() << "ms after starting authentication";
                 Q_EMIT auth->sessionStarted(status, pid);
-                str.reset();
-                str << SESSION_STATUS;
-                str.send();
+                send(WireWriter(SESSION_STATUS).data());
                 break;
             }
         case DISPLAY_SERVER_STARTED: {
                 QString displayName;
                 str >> displayName;
                 Q_EMIT auth->displayServerReady(displayName);
-                str.reset();
-                str << DISPLAY_SERVER_STARTED;
-                str.send();
+                send(WireWriter(DISPLAY_SERVER_STARTED).data());
                 break;
             }
             default: {
-                Q_EMIT auth->error(QStringLiteral("Auth: Unexpected value received: %1").arg(m), ERROR_INTERNAL);
+                Q_EMIT auth->error(QStringLiteral("Auth: Unexpected value received: %1").arg(str.message()), ERROR_INTERNAL);
             }
         }
     }
@@ -240,10 +302,9 @@ namespace SDDM {
     }
 
     void Auth::Private::requestFinished() {
-        SafeDataStream str(socket);
-        Request r = request->request();
-        str << REQUEST << r;
-        str.send();
+        WireWriter str(REQUEST);
+        str << request->request();
+        send(str.data());
         request->setRequest();
     }
 
@@ -310,7 +371,11 @@ namespace SDDM {
     }
 
     void Auth::insertEnvironment(const QProcessEnvironment &env) {
-        d->environment.insert(env);
+        // share rather than copy when there is nothing to merge with
+        if (d->environment.isEmpty())
+            d->environment = env;
+        else
+            d->environment.insert(env);
     }
 
     void Auth::insertEnvironment(const QString &key, const QString &value) {
@@ -361,6 +426,10 @@ namespace SDDM {
         }
     }
 
+    void Auth::setZygote(HelperZygote *zygote) {
+        d->zygote = zygote;
+    }
+
     void Auth::setVerbose(bool on) {
         if (on != verbose()) {
             if (on)
@@ -373,8 +442,6 @@ namespace SDDM {
 
     void Auth::start() {
         QStringList args;
-        args << QStringLiteral("--socket") << SocketServer::instance()->fullServerName();
-        args << QStringLiteral("--id") << QStringLiteral("%1").arg(d->id);
         if (!d->sessionPath.isEmpty())
             args << QStringLiteral("--start") << d->sessionPath;
         if (!d->user.isEmpty())
@@ -385,7 +452,49 @@ namespace SDDM {
             args << QStringLiteral("--display-server") << d->displayServerCmd;
         if (d->greeter)
             args << QStringLiteral("--greeter");
+
+        d->startTimer.start();
+
+        // a helper that is already up only needs to be told what to do.
+        // It has the "sddm" PAM service open, which is of no use to the
+        // greeter's sddm-greeter, and it forwards its output, which only
+        // a verbose Auth does.
+        const bool canAdopt = d->zygote && !d->greeter && verbose();
+        HelperProcess *parked = nullptr;
+        QLocalSocket *parkedSocket = nullptr;
+        if (canAdopt && d->zygote->take(&parked, &parkedSocket)) {
+            d->adopt(parked, parkedSocket);
+            WireWriter out(START);
+            out << args;
+            d->send(out.data());
+            return;
+        }
+
+        // a private channel, unless we can't get one
+        int fds[2] = { -1, -1 };
+        if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) == 0) {
+            QLocalSocket *socket = new QLocalSocket(d);
+            socket->setSocketDescriptor(fds[0]);
+            FramedChannel *channel = new FramedChannel(socket, socket);
+            channel->setPacketMode(true);
+            d->setChannel(channel);
+            args << QStringLiteral("--fd") << QString::number(fds[1]);
+        } else {
+            qWarning() << "Auth: Failed to create a socket pair, falling back to the shared socket:" << strerror(errno);
+            if (!d->registered) {
+                SocketServer::instance()->helpers[d->id] = d;
+                d->registered = true;
+            }
+            args << QStringLiteral("--socket") << SocketServer::instance()->fullServerName();
+            args << QStringLiteral("--id") << QStringLiteral("%1").arg(d->id);
+        }
+        // only the helper's end survives the exec
+        d->child->setInheritedFd(fds[1]);
         d->child->start(QStringLiteral("%1/sddm-helper").arg(QStringLiteral(LIBEXEC_INSTALL_DIR)), args);
+
+        // the child has its copy now
+        if (fds[1] >= 0)
+            ::close(fds[1]);
     }
 }
 
@@ -28,6 +28,8 @@
 #include <QtCore/QProcessEnvironment>
 
 namespace SDDM {
+    class HelperZygote;
+
     /**
     * \brief
     * Main class triggering the authentication and handling all communication
@@ -159,6 +161,12 @@ namespace SDDM {
          */
         void setCookie(const QString &cookie);
 
+        /**
+         * Take the helper from @p zygote instead of starting one, if it has one ready
+         * @param zygote helpers started ahead of time, or nullptr
+         */
+        void setZygote(HelperZygote *zygote);
+
     public Q_SLOTS:
         /**
         * Sets up the environment and starts the authentication
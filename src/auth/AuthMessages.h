@@ -98,6 +98,7 @@ namespace SDDM {
         AUTHENTICATED,
         SESSION_STATUS,
         DISPLAY_SERVER_STARTED,
+        START,
         MSG_LAST,
     };
 
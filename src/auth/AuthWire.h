@@ -0,0 +1,338 @@
+/*
+ * Binary encoding of the messages between the library and the helper
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AUTHWIRE_H
+#define AUTHWIRE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "AuthMessages.h"
+
+// bump whenever the layout of any message changes
+#define AUTH_PROTOCOL_VERSION 2
+
+namespace SDDM {
+    /*
+     * Every message starts with two bytes, the protocol version and the Msg
+     * id, followed by its fields:
+     *
+     *  - unsigned integers and booleans are LEB128 varints, signed integers
+     *    are zigzag encoded first
+     *  - strings are UTF-8 and, like byte arrays, prefixed with their length
+     *  - string lists are the number of strings followed by the strings
+     *  - requests are the number of prompts followed by the prompts, each
+     *    being its type, message, hidden flag and response
+     *  - environments are either complete (mode 0: count, key/value pairs)
+     *    or a delta against a base known to both sides (mode 1: removed
+     *    keys, then changed key/value pairs), whichever is shorter
+     *
+     * The length of a message is given by the frame around it.
+     */
+    enum WireEnvironmentMode {
+        WIRE_ENVIRONMENT_FULL = 0,
+        WIRE_ENVIRONMENT_DELTA = 1,
+    };
+
+    class WireWriter {
+    public:
+        explicit WireWriter(Msg message) {
+            m_data.reserve(64);
+            m_data.append(char(AUTH_PROTOCOL_VERSION));
+            m_data.append(char(message));
+        }
+
+        const QByteArray &data() const {
+            return m_data;
+        }
+
+        void writeUnsigned(quint64 value) {
+            while (value >= 0x80) {
+                m_data.append(char((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            m_data.append(char(value));
+        }
+
+        void writeSigned(qint64 value) {
+            writeUnsigned((quint64(value) << 1) ^ quint64(value >> 63));
+        }
+
+        void writeBytes(const QByteArray &value) {
+            writeUnsigned(quint64(value.size()));
+            m_data.append(value);
+        }
+
+        WireWriter &operator<<(bool value) {
+            writeUnsigned(value ? 1 : 0);
+            return *this;
+        }
+
+        WireWriter &operator<<(qint64 value) {
+            writeSigned(value);
+            return *this;
+        }
+
+        WireWriter &operator<<(const QString &value) {
+            writeBytes(value.toUtf8());
+            return *this;
+        }
+
+        WireWriter &operator<<(const QByteArray &value) {
+            writeBytes(value);
+            return *this;
+        }
+
+        WireWriter &operator<<(const QStringList &value) {
+            writeUnsigned(quint64(value.size()));
+            for (const QString &s : value)
+                *this << s;
+            return *this;
+        }
+
+        WireWriter &operator<<(Auth::Error value) {
+            writeUnsigned(quint64(value));
+            return *this;
+        }
+
+        WireWriter &operator<<(Auth::Info value) {
+            writeUnsigned(quint64(value));
+            return *this;
+        }
+
+        WireWriter &operator<<(const Prompt &value) {
+            writeUnsigned(quint64(value.type));
+            *this << value.message << value.hidden << value.response;
+            return *this;
+        }
+
+        WireWriter &operator<<(const Request &value) {
+            writeUnsigned(quint64(value.prompts.size()));
+            for (const Prompt &p : value.prompts)
+                *this << p;
+            return *this;
+        }
+
+        void writeEnvironment(const QProcessEnvironment &env, const QProcessEnvironment &base) {
+            const QStringList keys = env.keys();
+            QStringList removed;
+            QStringList changed;
+            for (const QString &key : base.keys()) {
+                if (!env.contains(key))
+                    removed << key;
+            }
+            for (const QString &key : keys) {
+                if (!base.contains(key) || base.value(key) != env.value(key))
+                    changed << key;
+            }
+
+            if (removed.size() + changed.size() < keys.size()) {
+                writeUnsigned(WIRE_ENVIRONMENT_DELTA);
+                writeUnsigned(quint64(removed.size()));
+                for (const QString &key : qAsConst(removed))
+                    *this << key;
+            } else {
+                writeUnsigned(WIRE_ENVIRONMENT_FULL);
+                changed = keys;
+            }
+            writeUnsigned(quint64(changed.size()));
+            for (const QString &key : qAsConst(changed))
+                *this << key << env.value(key);
+        }
+
+    private:
+        QByteArray m_data;
+    };
+
+    /*
+     * Reads a message written by WireWriter. Anything malformed, including
+     * a different protocol version, makes isValid() return false and all
+     * further reads return empty values.
+     */
+    class WireReader {
+    public:
+        explicit WireReader(const QByteArray &data) : m_data(data) {
+            const quint64 version = readByte();
+            const quint64 message = readByte();
+            if (version != AUTH_PROTOCOL_VERSION || message <= quint64(MSG_UNKNOWN) || message >= quint64(MSG_LAST))
+                m_valid = false;
+            else
+                m_message = Msg(message);
+        }
+
+        bool isValid() const {
+            return m_valid;
+        }
+
+        bool atEnd() const {
+            return m_position >= m_data.size();
+        }
+
+        Msg message() const {
+            return m_message;
+        }
+
+        quint64 readUnsigned() {
+            quint64 value = 0;
+            for (int shift = 0; m_valid && shift < 64; shift += 7) {
+                const quint64 byte = readByte();
+                value |= (byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            m_valid = false;
+            return 0;
+        }
+
+        qint64 readSigned() {
+            const quint64 value = readUnsigned();
+            return qint64(value >> 1) ^ -qint64(value & 1);
+        }
+
+        QByteArray readBytes() {
+            const quint64 length = readUnsigned();
+            if (!m_valid || length > quint64(m_data.size() - m_position)) {
+                m_valid = false;
+                return QByteArray();
+            }
+            const QByteArray value = m_data.mid(m_position, int(length));
+            m_position += int(length);
+            return value;
+        }
+
+        WireReader &operator>>(bool &value) {
+            value = readUnsigned() != 0;
+            return *this;
+        }
+
+        WireReader &operator>>(qint64 &value) {
+            value = readSigned();
+            return *this;
+        }
+
+        WireReader &operator>>(QString &value) {
+            value = QString::fromUtf8(readBytes());
+            return *this;
+        }
+
+        WireReader &operator>>(QByteArray &value) {
+            value = readBytes();
+            return *this;
+        }
+
+        WireReader &operator>>(QStringList &value) {
+            value.clear();
+            const quint64 count = readUnsigned();
+            // every string takes at least one byte
+            if (count > quint64(m_data.size() - m_position))
+                m_valid = false;
+            for (quint64 i = 0; m_valid && i < count; i++) {
+                QString s;
+                *this >> s;
+                value << s;
+            }
+            if (!m_valid)
+                value.clear();
+            return *this;
+        }
+
+        WireReader &operator>>(Auth::Error &value) {
+            const quint64 i = readUnsigned();
+            if (i >= quint64(Auth::_ERROR_LAST))
+                m_valid = false;
+            value = m_valid ? Auth::Error(i) : Auth::ERROR_NONE;
+            return *this;
+        }
+
+        WireReader &operator>>(Auth::Info &value) {
+            const quint64 i = readUnsigned();
+            if (i >= quint64(Auth::_INFO_LAST))
+                m_valid = false;
+            value = m_valid ? Auth::Info(i) : Auth::INFO_NONE;
+            return *this;
+        }
+
+        WireReader &operator>>(Prompt &value) {
+            value.type = AuthPrompt::Type(readUnsigned());
+            *this >> value.message >> value.hidden >> value.response;
+            return *this;
+        }
+
+        WireReader &operator>>(Request &value) {
+            value.prompts.clear();
+            const quint64 count = readUnsigned();
+            // every prompt takes at least four bytes
+            if (count > quint64(m_data.size() - m_position) / 4)
+                m_valid = false;
+            for (quint64 i = 0; m_valid && i < count; i++) {
+                Prompt p;
+                *this >> p;
+                value.prompts << p;
+            }
+            if (!m_valid)
+                value.prompts.clear();
+            return *this;
+        }
+
+        void readEnvironment(QProcessEnvironment &env, const QProcessEnvironment &base) {
+            const quint64 mode = readUnsigned();
+            if (mode == WIRE_ENVIRONMENT_DELTA) {
+                env = base;
+                const quint64 removed = readUnsigned();
+                for (quint64 i = 0; m_valid && i < removed; i++) {
+                    QString key;
+                    *this >> key;
+                    env.remove(key);
+                }
+            } else if (mode == WIRE_ENVIRONMENT_FULL) {
+                env = QProcessEnvironment();
+            } else {
+                m_valid = false;
+            }
+
+            const quint64 count = m_valid ? readUnsigned() : 0;
+            for (quint64 i = 0; m_valid && i < count; i++) {
+                QString key, value;
+                *this >> key >> value;
+                env.insert(key, value);
+            }
+            if (!m_valid)
+                env = QProcessEnvironment();
+        }
+
+    private:
+        quint64 readByte() {
+            if (!m_valid || m_position >= m_data.size()) {
+                m_valid = false;
+                return 0;
+            }
+            return quint8(m_data.at(m_position++));
+        }
+
+        const QByteArray m_data;
+        int m_position { 0 };
+        bool m_valid { true };
+        Msg m_message { MSG_UNKNOWN };
+    };
+}
+
+#endif // AUTHWIRE_H
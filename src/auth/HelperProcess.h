@@ -0,0 +1,60 @@
+/*
+ * An sddm-helper process that inherits its end of a socket pair
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SDDM_HELPERPROCESS_H
+#define SDDM_HELPERPROCESS_H
+
+#include <QtCore/QProcess>
+
+#include <fcntl.h>
+
+namespace SDDM {
+    /**
+    * \brief
+    * Process that keeps one close-on-exec descriptor open across its exec
+    *
+    * \section description
+    * The daemon creates its socket pairs with SOCK_CLOEXEC so that no other
+    * child it starts in the meantime gets a copy. Only the forked child
+    * clears the flag on the end that sddm-helper is told about.
+    */
+    class HelperProcess : public QProcess {
+    public:
+        explicit HelperProcess(QObject *parent = nullptr) : QProcess(parent) { }
+
+        /**
+        * Descriptor to keep open in the next started process, -1 for none
+        */
+        void setInheritedFd(int fd) {
+            m_inheritedFd = fd;
+        }
+
+    protected:
+        void setupChildProcess() override {
+            if (m_inheritedFd >= 0)
+                ::fcntl(m_inheritedFd, F_SETFD, 0);
+        }
+
+    private:
+        int m_inheritedFd { -1 };
+    };
+}
+
+#endif // SDDM_HELPERPROCESS_H
@@ -0,0 +1,115 @@
+/*
+ * Keeps an sddm-helper started ahead of time
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "HelperZygote.h"
+#include "Constants.h"
+#include "EnvironmentTemplate.h"
+#include "HelperProcess.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QProcess>
+#include <QtCore/QTimer>
+#include <QtNetwork/QLocalSocket>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// delay before replacing a helper that exited while parked
+#define RESPAWN_DELAY 5000
+
+namespace SDDM {
+    HelperZygote::HelperZygote(QObject *parent)
+            : QObject(parent)
+            , m_respawnTimer(new QTimer(this)) {
+        m_respawnTimer->setSingleShot(true);
+        m_respawnTimer->setInterval(RESPAWN_DELAY);
+        connect(m_respawnTimer, &QTimer::timeout, this, &HelperZygote::spawn);
+
+        spawn();
+    }
+
+    HelperZygote::~HelperZygote() {
+        // the helper quits as soon as its socket is closed
+        delete m_socket;
+        delete m_process;
+    }
+
+    bool HelperZygote::take(HelperProcess **process, QLocalSocket **socket) {
+        if (!m_process || m_process->state() == QProcess::NotRunning) {
+            if (!m_process && !m_respawnTimer->isActive())
+                QTimer::singleShot(0, this, &HelperZygote::spawn);
+            return false;
+        }
+
+        m_process->disconnect(this);
+        *process = m_process;
+        *socket = m_socket;
+        m_process = nullptr;
+        m_socket = nullptr;
+
+        // have the next one ready once control is back in the event loop
+        QTimer::singleShot(0, this, &HelperZygote::spawn);
+        return true;
+    }
+
+    void HelperZygote::spawn() {
+        if (m_process)
+            return;
+
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0) {
+            qWarning() << "HelperZygote: Failed to create a socket pair:" << strerror(errno);
+            return;
+        }
+
+        m_socket = new QLocalSocket(this);
+        m_socket->setSocketDescriptor(fds[0]);
+
+        m_process = new HelperProcess(this);
+        m_process->setProcessEnvironment(EnvironmentTemplate::locale());
+        m_process->setProcessChannelMode(QProcess::ForwardedChannels);
+        connect(m_process, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, &HelperZygote::parkedExited);
+        connect(m_process, QOverload<QProcess::ProcessError>::of(&QProcess::error), this, &HelperZygote::parkedExited);
+
+        QStringList args;
+        args << QStringLiteral("--fd") << QString::number(fds[1]) << QStringLiteral("--zygote");
+        // only the helper's end survives the exec
+        m_process->setInheritedFd(fds[1]);
+        m_process->start(QStringLiteral("%1/sddm-helper").arg(QStringLiteral(LIBEXEC_INSTALL_DIR)), args);
+
+        // the child has its copy now
+        ::close(fds[1]);
+    }
+
+    void HelperZygote::parkedExited() {
+        if (!m_process)
+            return;
+
+        qWarning("HelperZygote: Parked sddm-helper quit, starting another one in %d ms", RESPAWN_DELAY);
+        m_process->disconnect(this);
+        m_process->deleteLater();
+        m_process = nullptr;
+        m_socket->deleteLater();
+        m_socket = nullptr;
+        m_respawnTimer->start();
+    }
+}
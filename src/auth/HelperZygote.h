@@ -0,0 +1,69 @@
+/*
+ * Keeps an sddm-helper started ahead of time
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SDDM_HELPERZYGOTE_H
+#define SDDM_HELPERZYGOTE_H
+
+#include <QtCore/QObject>
+
+class QLocalSocket;
+class QTimer;
+
+namespace SDDM {
+    class HelperProcess;
+
+    /**
+    * \brief
+    * A started sddm-helper waiting for its arguments
+    *
+    * \section description
+    * Starting sddm-helper means loading Qt, parsing the configuration and
+    * loading the PAM modules, which the user would otherwise wait for after
+    * pressing Enter. The zygote does that ahead of time: it keeps one helper
+    * parked on its end of a socket pair until \ref Auth takes it over and
+    * sends it the arguments it would have been started with. A replacement
+    * is started as soon as the parked helper is taken.
+    */
+    class HelperZygote : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(HelperZygote)
+    public:
+        explicit HelperZygote(QObject *parent = nullptr);
+        ~HelperZygote();
+
+        /**
+        * Hands out the parked helper and the daemon's end of its socket.
+        * The caller becomes responsible for both.
+        * @return false if there is no helper ready
+        */
+        bool take(HelperProcess **process, QLocalSocket **socket);
+
+    private slots:
+        void spawn();
+        void parkedExited();
+
+    private:
+        HelperProcess *m_process { nullptr };
+        QLocalSocket *m_socket { nullptr };
+        QTimer *m_respawnTimer { nullptr };
+    };
+}
+
+#endif // SDDM_HELPERZYGOTE_H
@@ -27,45 +27,409 @@
 #include <QtCore/QMap>
 #include <QtCore/QBuffer>
 #include <QtCore/QFileInfo>
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QByteArrayList>
+#include <QtCore/QSet>
 
-QTextStream &operator>>(QTextStream &str, QStringList &list)  {
-    list.clear();
+#include <algorithm>
 
-    QString line = str.readLine();
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-    const auto strings = line.splitRef(QLatin1Char(','));
-    for (const QStringRef &s : strings) {
-        QStringRef trimmed = s.trimmed();
-        if (!trimmed.isEmpty())
-            list.append(trimmed.toString());
+#define SNAPSHOT_MAGIC 0x53444d43 // "SDMC"
+#define SNAPSHOT_VERSION 1
+
+// size above which the journal is folded back into the configuration file
+#define JOURNAL_COMPACT_SIZE 4096
+
+namespace SDDM {
+    class ConfigJournal::Writer : public QThread {
+    public:
+        Writer(const QString &path, const QString &configPath)
+            : m_path(QFile::encodeName(path))
+            , m_configPath(configPath) {
+        }
+
+        ~Writer() {
+            {
+                QMutexLocker locker(&m_mutex);
+                m_stopping = true;
+                m_wake.wakeOne();
+            }
+            wait();
+            if (m_fd >= 0)
+                ::close(m_fd);
+        }
+
+        void append(const QByteArray &record) {
+            QMutexLocker locker(&m_mutex);
+            m_records.append(record);
+            m_wake.wakeOne();
+        }
+
+        void flush() {
+            QMutexLocker locker(&m_mutex);
+            while (!m_records.isEmpty() || m_busy)
+                m_idle.wait(&m_mutex);
+        }
+
+    protected:
+        void run() override {
+            QMutexLocker locker(&m_mutex);
+            for (;;) {
+                while (m_records.isEmpty() && !m_stopping)
+                    m_wake.wait(&m_mutex);
+                if (m_records.isEmpty())
+                    break;
+
+                // everything queued meanwhile goes out with a single sync
+                const QByteArray records = m_records;
+                m_records.clear();
+                m_busy = true;
+
+                locker.unlock();
+                write(records);
+                locker.relock();
+
+                m_busy = false;
+                m_idle.wakeAll();
+            }
+        }
+
+    private:
+        void write(const QByteArray &records) {
+            if (m_fd < 0) {
+                m_fd = ::open(m_path.constData(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+                if (m_fd < 0) {
+                    qWarning() << "Failed to open journal" << m_path << ":" << strerror(errno);
+                    return;
+                }
+                repair();
+            }
+
+            const char *data = records.constData();
+            qint64 remaining = records.size();
+            while (remaining > 0) {
+                const ssize_t written = ::write(m_fd, data, size_t(remaining));
+                if (written < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    qWarning() << "Failed to write journal" << m_path << ":" << strerror(errno);
+                    return;
+                }
+                data += written;
+                remaining -= written;
+            }
+            ::fdatasync(m_fd);
+
+            struct stat st;
+            if (::fstat(m_fd, &st) == 0 && st.st_size > JOURNAL_COMPACT_SIZE)
+                compact();
+        }
+
+        // cuts off a record which a crash left incomplete, so that the
+        // next one doesn't get appended to it
+        void repair() {
+            QFile file;
+            if (!file.open(m_fd, QIODevice::ReadOnly, QFileDevice::DontCloseHandle))
+                return;
+            const QByteArray data = file.readAll();
+            if (data.isEmpty() || data.endsWith('\n'))
+                return;
+            if (::ftruncate(m_fd, data.lastIndexOf('\n') + 1) == 0)
+                ::fdatasync(m_fd);
+        }
+
+        void compact() {
+            // the journal holds everything saved since the last compaction
+            QFile journal;
+            if (!journal.open(m_fd, QIODevice::ReadOnly, QFileDevice::DontCloseHandle) || !journal.seek(0))
+                return;
+            const QByteArray records = journal.readAll();
+            journal.close();
+
+            QByteArray contents;
+            QFile current(m_configPath);
+            if (current.open(QIODevice::ReadOnly))
+                contents = current.readAll();
+            contents = merge(contents, records);
+
+            // QSaveFile syncs the new file before renaming it over the old one
+            QSaveFile file(m_configPath);
+            if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size() || !file.commit()) {
+                qWarning() << "Failed to compact journal into" << m_configPath << ":" << file.errorString();
+                return;
+            }
+
+            // make the rename durable before dropping the records it contains
+            const QByteArray dirPath = QFile::encodeName(QFileInfo(m_configPath).absolutePath());
+            const int dir = ::open(dirPath.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dir >= 0) {
+                ::fsync(dir);
+                ::close(dir);
+            }
+
+            if (::ftruncate(m_fd, 0) == 0)
+                ::fdatasync(m_fd);
+        }
+
+        // sets the values of the journal records in the configuration file
+        // text, like ConfigBase::save() leaving everything else as it is
+        static QByteArray merge(const QByteArray &contents, const QByteArray &records) {
+            // the last value of every key, by section, in order of appearance
+            QVector<QByteArray> sections;
+            QHash<QByteArray, QVector<QPair<QByteArray, QByteArray>>> values;
+            QByteArray section = IMPLICIT_SECTION;
+            for (const QByteArray &line : records.split('\n')) {
+                const QByteArray trimmed = line.trimmed();
+                if (trimmed.startsWith('[') && trimmed.endsWith(']')) {
+                    section = trimmed.mid(1, trimmed.size() - 2);
+                    continue;
+                }
+                const int separator = trimmed.indexOf('=');
+                if (separator <= 0)
+                    continue;
+                if (!values.contains(section))
+                    sections << section;
+                auto &sectionValues = values[section];
+                const QByteArray key = trimmed.left(separator).trimmed();
+                const QByteArray value = trimmed.mid(separator + 1).trimmed();
+                auto it = std::find_if(sectionValues.begin(), sectionValues.end(), [&key](const QPair<QByteArray, QByteArray> &v) { return v.first == key; });
+                if (it != sectionValues.end())
+                    it->second = value;
+                else
+                    sectionValues.append(qMakePair(key, value));
+            }
+
+            QList<QByteArray> lines = contents.split('\n');
+            if (!lines.isEmpty() && lines.last().isEmpty())
+                lines.removeLast();
+
+            auto find = [&values](const QByteArray &section, const QByteArray &key) {
+                const QPair<QByteArray, QByteArray> *found = nullptr;
+                auto it = values.constFind(section);
+                if (it != values.constEnd()) {
+                    for (const auto &value : *it) {
+                        if (value.first == key)
+                            found = &value;
+                    }
+                }
+                return found;
+            };
+
+            QByteArrayList out;
+            QSet<QByteArray> written;
+            QSet<QByteArray> completed;
+            section = IMPLICIT_SECTION;
+            // where keys missing from the current section go, after its
+            // last assignment rather than before the comments of the next
+            int insertAt = 0;
+            auto addMissing = [&]() {
+                if (completed.contains(section))
+                    return;
+                completed.insert(section);
+                for (const auto &value : values.value(section)) {
+                    if (!written.contains(section + '\n' + value.first))
+                        out.insert(insertAt++, value.first + '=' + value.second);
+                }
+            };
+
+            for (const QByteArray &line : qAsConst(lines)) {
+                const int commentPosition = line.indexOf('#');
+                const QByteArray trimmed = line.left(commentPosition < 0 ? line.size() : commentPosition).trimmed();
+
+                if (trimmed.startsWith('[') && trimmed.endsWith(']')) {
+                    addMissing();
+                    section = trimmed.mid(1, trimmed.size() - 2);
+                    out << line;
+                    insertAt = out.size();
+                    continue;
+                }
+
+                const int separator = trimmed.indexOf('=');
+                if (separator <= 0) {
+                    out << line;
+                    continue;
+                }
+
+                const QByteArray key = trimmed.left(separator).trimmed();
+                if (const auto *value = find(section, key)) {
+                    QByteArray replaced = key + '=' + value->second;
+                    if (commentPosition >= 0)
+                        replaced += ' ' + line.mid(commentPosition).trimmed();
+                    out << replaced;
+                    written.insert(section + '\n' + key);
+                } else {
+                    out << line;
+                }
+                insertAt = out.size();
+            }
+            addMissing();
+
+            // sections the file doesn't have yet
+            for (const QByteArray &name : qAsConst(sections)) {
+                if (completed.contains(name))
+                    continue;
+                if (!out.isEmpty())
+                    out << QByteArray();
+                out << '[' + name + ']';
+                for (const auto &value : values.value(name))
+                    out << value.first + '=' + value.second;
+            }
+
+            QByteArray merged = out.join('\n');
+            if (!merged.isEmpty())
+                merged += '\n';
+            return merged;
+        }
+
+        const QByteArray m_path;
+        const QString m_configPath;
+        int m_fd { -1 };
+
+        QMutex m_mutex;
+        QWaitCondition m_wake;
+        QWaitCondition m_idle;
+        QByteArray m_records;
+        bool m_busy { false };
+        bool m_stopping { false };
+    };
+
+    ConfigJournal::ConfigJournal(ConfigBase *parent) : m_parent(parent) {
+        parent->m_journalPath = parent->m_path + QStringLiteral(".journal");
+        parent->m_journal = this;
     }
 
-    return str;
-}
+    ConfigJournal::~ConfigJournal() {
+        delete m_writer;
+    }
 
-QTextStream &operator<<(QTextStream &str, const QStringList &list) {
-    str << list.join(QLatin1Char(','));
-    return str;
-}
+    void ConfigJournal::append(const QByteArray &record) {
+        if (!m_writer) {
+            m_writer = new Writer(m_parent->m_journalPath, m_parent->m_path);
+            m_writer->start();
+        }
+        m_writer->append(record);
+    }
 
-QTextStream &operator>>(QTextStream &str, bool &val) {
-    QString line = str.readLine();
-    val = (0 == QStringRef(&line).trimmed().compare(QLatin1String("true"), Qt::CaseInsensitive));
-    return str;
-}
+    void ConfigJournal::flush() {
+        if (m_writer)
+            m_writer->flush();
+    }
 
-QTextStream &operator<<(QTextStream &str, const bool &val) {
-    if (val)
-        str << "true";
-    else
-        str << "false";
-    return str;
-}
+    ConfigSnapshot::ConfigSnapshot(ConfigBase *parent, const QString &path) {
+        parent->m_snapshotPath = path;
+    }
 
-namespace SDDM {
-    // has to be specialised because QTextStream reads only words into a QString
-    template <> void ConfigEntry<QString>::setValue(const QString &str) {
-        m_value = str.trimmed();
+    ConfigSnapshot::Input ConfigSnapshot::stat(const QString &path) {
+        Input input;
+        input.path = QFile::encodeName(path);
+
+        struct stat st;
+        if (::stat(input.path.constData(), &st) == 0) {
+            input.exists = true;
+            input.device = quint64(st.st_dev);
+            input.inode = quint64(st.st_ino);
+            input.size = qint64(st.st_size);
+            input.modified = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        }
+
+        return input;
+    }
+
+
+    // Finds a seed for which all names land in different buckets. With at
+    // least n^2 buckets a random seed works more than half of the time.
+    template <class Info>
+    static ConfigSchema::Table buildTable(const QVector<Info> &infos, int first, int count) {
+        uint size = 1;
+        while (size < uint(count * count))
+            size <<= 1;
+
+        for (;;) {
+            for (uint seed = 0; seed < 64; seed++) {
+                QVector<int> buckets(int(size), -1);
+                bool perfect = true;
+                for (int id = first; perfect && id < first + count; id++) {
+                    int &bucket = buckets[int(qHash(QStringRef(&infos.at(id).name), seed) & (size - 1))];
+                    if (bucket >= 0)
+                        perfect = false;
+                    else
+                        bucket = id;
+                }
+                if (perfect) {
+                    ConfigSchema::Table table;
+                    table.seed = seed;
+                    table.mask = size - 1;
+                    table.buckets = buckets;
+                    return table;
+                }
+            }
+            size <<= 1;
+        }
+    }
+
+    template <class Info>
+    static int lookupTable(const ConfigSchema::Table &table, const QVector<Info> &infos, const QStringRef &name) {
+        const int id = table.buckets.at(int(qHash(name, table.seed) & table.mask));
+        if (id >= 0 && infos.at(id).name == name)
+            return id;
+        return -1;
+    }
+
+    ConfigSchema::ConfigSchema(const ConfigBase &prototype) {
+        for (const ConfigSection *section : prototype.m_sections) {
+            SectionInfo info { section->name(), m_entries.size(), 0 };
+            for (const ConfigEntryBase *entry : section->entries())
+                m_entries.append({ m_sections.size(), entry->name(), entry->type(), entry->defaultValue(), entry->description() });
+            info.entryCount = m_entries.size() - info.firstEntry;
+            m_sections.append(info);
+        }
+
+        m_sectionTable = buildTable(m_sections, 0, m_sections.size());
+        m_entryTables.reserve(m_sections.size());
+        for (const SectionInfo &section : qAsConst(m_sections))
+            m_entryTables.append(buildTable(m_entries, section.firstEntry, section.entryCount));
+    }
+
+    const QVector<ConfigSchema::SectionInfo> &ConfigSchema::sections() const {
+        return m_sections;
+    }
+
+    const QVector<ConfigSchema::EntryInfo> &ConfigSchema::entries() const {
+        return m_entries;
+    }
+
+    int ConfigSchema::sectionId(const QStringRef &name) const {
+        return lookupTable(m_sectionTable, m_sections, name);
+    }
+
+    int ConfigSchema::entryId(int section, const QStringRef &name) const {
+        if (section < 0 || section >= m_entryTables.size())
+            return -1;
+        return lookupTable(m_entryTables.at(section), m_entries, name);
+    }
+
+    QString ConfigSchema::toConfigFull() const {
+        QString ret;
+        for (const SectionInfo &section : m_sections) {
+            ret.append(QStringLiteral("[%1]\n").arg(section.name));
+            for (int id = section.firstEntry; id < section.firstEntry + section.entryCount; id++) {
+                const EntryInfo &entry = m_entries.at(id);
+                for (const QString &line : entry.description.split(QLatin1Char('\n')))
+                    ret.append(QStringLiteral("# %1\n").arg(line));
+                ret.append(QStringLiteral("%1=%2\n\n").arg(entry.name).arg(entry.defaultValue));
+            }
+            ret.append(QLatin1Char('\n'));
+        }
+        return ret;
     }
 
 
@@ -127,6 +491,18 @@ namespace SDDM {
     {
     }
 
+    void ConfigBase::setSchema(const ConfigSchema *schema) {
+        m_schema = schema;
+
+        // same order as the one the schema was created in
+        m_entryTable.clear();
+        m_entryTable.reserve(schema->entries().size());
+        for (const ConfigSection *s : qAsConst(m_sections)) {
+            for (ConfigEntryBase *entry : s->entries())
+                m_entryTable.append(entry);
+        }
+    }
+
     bool ConfigBase::hasUnused() const {
         return m_unusedSections || m_unusedVariables;
     }
@@ -141,6 +517,17 @@ namespace SDDM {
     }
 
     void ConfigBase::load()
+    {
+        loadFiles();
+
+        if (m_journal) {
+            m_journaled.resize(m_entryTable.size());
+            for (int id = 0; id < m_entryTable.size(); id++)
+                m_journaled[id] = m_entryTable.at(id)->value();
+        }
+    }
+
+    void ConfigBase::loadFiles()
     {
         //order of priority from least influence to most influence, is
         // * m_sysConfigDir (system settings /usr/lib/sddm/sddm.conf.d/) in alphabetical order
@@ -177,19 +564,166 @@ namespace SDDM {
 
         files << m_path;
 
+        // whatever has been saved since the last compaction
+        if (!m_journalPath.isEmpty()) {
+            files << m_journalPath;
+            latestModificationTime = std::max(latestModificationTime, QFileInfo(m_journalPath).lastModified());
+        }
+
         if (latestModificationTime <= m_fileModificationTime) {
             return;
         }
         m_fileModificationTime = latestModificationTime;
 
+        if (m_snapshotPath.isEmpty()) {
+            for (const QString &filepath : qAsConst(files)) {
+                loadInternal(filepath);
+            }
+            return;
+        }
+
+        // try to reuse what another process has already parsed
+        const QVector<ConfigSnapshot::Input> inputs = snapshotInputs(files);
+        if (loadSnapshot(inputs))
+            return;
+
+        QVector<ConfigSnapshot::Assignment> assignments;
         for (const QString &filepath : qAsConst(files)) {
-            loadInternal(filepath);
+            loadInternal(filepath, &assignments);
+        }
+
+        // don't store anything if a file was modified while we were reading it
+        if (snapshotInputs(files) == inputs)
+            saveSnapshot(inputs, assignments);
+    }
+
+    bool ConfigBase::reload() {
+        for (const ConfigSection *s : qAsConst(m_sections)) {
+            for (ConfigEntryBase *entry : s->entries())
+                entry->rememberValue();
+        }
+
+        // start over from the defaults so that removed entries are reset too
+        wipe();
+        m_fileModificationTime = QDateTime();
+        load();
+
+        bool changed = false;
+        for (const ConfigSection *s : qAsConst(m_sections)) {
+            for (ConfigEntryBase *entry : s->entries())
+                changed = entry->notifyIfChanged() || changed;
+        }
+        return changed;
+    }
+
+    QVector<ConfigSnapshot::Input> ConfigBase::snapshotInputs(const QStringList &files) const {
+        QVector<ConfigSnapshot::Input> inputs;
+        inputs.reserve(files.size() + 2);
+
+        // the directories change whenever a file is added or removed
+        if (!m_sysConfigDir.isEmpty())
+            inputs.append(ConfigSnapshot::stat(m_sysConfigDir));
+        if (!m_configDir.isEmpty())
+            inputs.append(ConfigSnapshot::stat(m_configDir));
+        for (const QString &filepath : files)
+            inputs.append(ConfigSnapshot::stat(filepath));
+
+        return inputs;
+    }
+
+    bool ConfigBase::loadSnapshot(const QVector<ConfigSnapshot::Input> &inputs) {
+        QFile file(m_snapshotPath);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+
+        // only trust snapshots written by root or by ourselves
+        struct stat st;
+        if (::fstat(file.handle(), &st) != 0 || (st.st_uid != 0 && st.st_uid != ::geteuid()))
+            return false;
+
+        const qint64 size = file.size();
+        uchar *data = file.map(0, size);
+        if (!data)
+            return false;
+
+        QDataStream in(QByteArray::fromRawData(reinterpret_cast<const char *>(data), size));
+        in.setVersion(QDataStream::Qt_5_8);
+
+        quint32 magic = 0, version = 0, count = 0;
+        in >> magic >> version >> count;
+        if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION || count != quint32(inputs.size()))
+            return false;
+
+        for (const ConfigSnapshot::Input &current : inputs) {
+            ConfigSnapshot::Input input;
+            in >> input.path >> input.exists >> input.device >> input.inode >> input.size >> input.modified;
+            if (in.status() != QDataStream::Ok || input != current)
+                return false;
         }
+
+        bool unusedVariables = false;
+        in >> unusedVariables >> count;
+
+        QVector<ConfigSnapshot::Assignment> assignments;
+        for (quint32 i = 0; i < count; i++) {
+            ConfigSnapshot::Assignment assignment;
+            in >> assignment.section >> assignment.entry >> assignment.value;
+            if (in.status() != QDataStream::Ok)
+                return false;
+            assignments.append(assignment);
+        }
+
+        for (const ConfigSnapshot::Assignment &assignment : qAsConst(assignments)) {
+            const int section = m_schema->sectionId(QStringRef(&assignment.section));
+            const int id = m_schema->entryId(section, QStringRef(&assignment.entry));
+            if (id >= 0)
+                m_entryTable.at(id)->setValue(assignment.value);
+        }
+        m_unusedVariables = m_unusedVariables || unusedVariables;
+
+        return true;
+    }
+
+    void ConfigBase::saveSnapshot(const QVector<ConfigSnapshot::Input> &inputs, const QVector<ConfigSnapshot::Assignment> &assignments) const {
+        // later assignments override earlier ones, keep only the last value of each entry
+        QVector<ConfigSnapshot::Assignment> merged;
+        QHash<QString, int> positions;
+        for (const ConfigSnapshot::Assignment &assignment : assignments) {
+            const QString key = QStringLiteral("%1/%2").arg(assignment.section).arg(assignment.entry);
+            auto it = positions.constFind(key);
+            if (it != positions.constEnd()) {
+                merged[it.value()].value = assignment.value;
+            } else {
+                positions.insert(key, merged.size());
+                merged.append(assignment);
+            }
+        }
+
+        // the greeter can't write here, which is fine - the daemon parses first
+        QDir().mkpath(QFileInfo(m_snapshotPath).absolutePath());
+        QSaveFile file(m_snapshotPath);
+        if (!file.open(QIODevice::WriteOnly))
+            return;
+
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_5_8);
+        out << quint32(SNAPSHOT_MAGIC) << quint32(SNAPSHOT_VERSION) << quint32(inputs.size());
+        for (const ConfigSnapshot::Input &input : inputs)
+            out << input.path << input.exists << input.device << input.inode << input.size << input.modified;
+        out << m_unusedVariables << quint32(merged.size());
+        for (const ConfigSnapshot::Assignment &assignment : qAsConst(merged))
+            out << assignment.section << assignment.entry << assignment.value;
+
+        if (out.status() == QDataStream::Ok)
+            file.commit();
+        else
+            file.cancelWriting();
     }
 
 
-    void ConfigBase::loadInternal(const QString &filepath) {
+    void ConfigBase::loadInternal(const QString &filepath, QVector<ConfigSnapshot::Assignment> *assignments) {
         QString currentSection = QStringLiteral(IMPLICIT_SECTION);
+        int sectionId = m_schema->sectionId(QStringRef(&currentSection));
 
         QFile in(filepath);
 
@@ -197,36 +731,78 @@ namespace SDDM {
             return;
         while (!in.atEnd()) {
             QString line = QString::fromUtf8(in.readLine());
+            // the last record of the journal may have been cut short
+            if (filepath == m_journalPath && !line.endsWith(QLatin1Char('\n')))
+                break;
             QStringRef lineRef = QStringRef(&line).trimmed();
             // get rid of comments first
             lineRef = lineRef.left(lineRef.indexOf(QLatin1Char('#'))).trimmed();
 
-            // In version 0.14.0, these sections were renamed
-            if (currentSection == QStringLiteral("XDisplay"))
-                currentSection = QStringLiteral("X11");
-            else if (currentSection == QStringLiteral("WaylandDisplay"))
-                currentSection = QStringLiteral("Wayland");
-
             // value assignment
             int separatorPosition = lineRef.indexOf(QLatin1Char('='));
             if (separatorPosition >= 0) {
-                QString name = lineRef.left(separatorPosition).trimmed().toString();
-                QStringRef value = lineRef.mid(separatorPosition + 1).trimmed();
-
-                auto sectionIterator = m_sections.constFind(currentSection);
-                if (sectionIterator != m_sections.constEnd() && sectionIterator.value()->entry(name))
-                    sectionIterator.value()->entry(name)->setValue(value.toString());
+                const QStringRef name = lineRef.left(separatorPosition).trimmed();
+                const int id = m_schema->entryId(sectionId, name);
+
+                if (id >= 0) {
+                    const QString value = lineRef.mid(separatorPosition + 1).trimmed().toString();
+                    m_entryTable.at(id)->setValue(value);
+                    if (assignments)
+                        assignments->append({ currentSection, name.toString(), value });
+                }
                 else
                     // if we don't have such member in the config, nag about it
                     m_unusedVariables = true;
             }
             // section start
-            else if (lineRef.startsWith(QLatin1Char('[')) && lineRef.endsWith(QLatin1Char(']')))
+            else if (lineRef.startsWith(QLatin1Char('[')) && lineRef.endsWith(QLatin1Char(']'))) {
                 currentSection = lineRef.mid(1, lineRef.length() - 2).toString();
+
+                // In version 0.14.0, these sections were renamed
+                if (currentSection == QStringLiteral("XDisplay"))
+                    currentSection = QStringLiteral("X11");
+                else if (currentSection == QStringLiteral("WaylandDisplay"))
+                    currentSection = QStringLiteral("Wayland");
+
+                sectionId = m_schema->sectionId(QStringRef(&currentSection));
+            }
         }
     }
 
+    void ConfigBase::saveJournal() {
+        // only what changed since the last load or save
+        QByteArray record;
+        int recordSection = -1;
+        for (int id = 0; id < m_entryTable.size(); id++) {
+            const QString value = m_entryTable.at(id)->value();
+            if (value == m_journaled.at(id))
+                continue;
+            m_journaled[id] = value;
+
+            const ConfigSchema::EntryInfo &info = m_schema->entries().at(id);
+            if (info.section != recordSection) {
+                recordSection = info.section;
+                record.append('[').append(m_schema->sections().at(recordSection).name.toUtf8()).append("]\n");
+            }
+            record.append(info.name.toUtf8()).append('=').append(value.toUtf8()).append('\n');
+        }
+        if (record.isEmpty())
+            return;
+
+        m_journal->append(record);
+    }
+
+    void ConfigBase::flush() {
+        if (m_journal)
+            m_journal->flush();
+    }
+
     void ConfigBase::save(const ConfigSection *section, const ConfigEntryBase *entry) {
+        if (m_journal) {
+            saveJournal();
+            return;
+        }
+
         // to know if we should overwrite the config or not
         bool changed = false;
         // stores the order of the loaded sections
@@ -27,6 +27,14 @@
 #include <QtCore/QDebug>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QVector>
+#include <QtCore/QPointer>
+
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 #define IMPLICIT_SECTION "General"
 #define UNUSED_VARIABLE_COMMENT "# Unused variable"
@@ -41,8 +49,14 @@
     class name : public SDDM::ConfigBase, public SDDM::ConfigSection { \
     public: \
         name() : SDDM::ConfigBase(file, dir, sysDir), SDDM::ConfigSection(this, QStringLiteral(IMPLICIT_SECTION)) { \
+            setSchema(&schema()); \
             load(); \
         } \
+        explicit name(SDDM::ConfigSchema::Prototype) : SDDM::ConfigBase(file, dir, sysDir), SDDM::ConfigSection(this, QStringLiteral(IMPLICIT_SECTION)) { } \
+        static const SDDM::ConfigSchema &schema() { \
+            static const SDDM::ConfigSchema s { name(SDDM::ConfigSchema::Prototype()) }; \
+            return s; \
+        } \
         void save() { SDDM::ConfigBase::save(nullptr, nullptr); } \
         void save(SDDM::ConfigEntryBase *) const = delete; \
         QString toConfigFull() const { \
@@ -60,20 +74,207 @@
         name (SDDM::ConfigBase *_parent, const QString &_name) : SDDM::ConfigSection(_parent, _name) { } \
         __VA_ARGS__ \
     } name { this, QStringLiteral(#name) };
-
-QTextStream &operator>>(QTextStream &str, QStringList &list);
-QTextStream &operator<<(QTextStream &str, const QStringList &list);
-QTextStream &operator>>(QTextStream &str, bool &val);
-QTextStream &operator<<(QTextStream &str, const bool &val);
+// binary snapshot wrapper - has to come before the entries of a Config
+#define Snapshot(path) \
+    SDDM::ConfigSnapshot _snapshot { this, (path) };
+// append-only journal for configurations written by the daemon itself
+#define Journal() \
+    SDDM::ConfigJournal _journal { this };
 
 namespace SDDM {
     template<class> class ConfigEntry;
     class ConfigSection;
     class ConfigBase;
+    class ConfigSnapshot;
+    class ConfigJournal;
+    class ConfigSchema;
+    class ConfigWatcher;
+
+    enum class ConfigType {
+        String,
+        StringList,
+        Bool,
+        Int,
+        Enum,
+        Other
+    };
+
+    template <class T> inline ConfigType configType() {
+        return std::is_enum<T>::value ? ConfigType::Enum : ConfigType::Other;
+    }
+    template <> inline ConfigType configType<QString>() { return ConfigType::String; }
+    template <> inline ConfigType configType<QStringList>() { return ConfigType::StringList; }
+    template <> inline ConfigType configType<bool>() { return ConfigType::Bool; }
+    template <> inline ConfigType configType<int>() { return ConfigType::Int; }
+
+    /**
+     * Textual value of an enumeration entry.
+     *
+     * Enumerations make themselves known to ConfigCodec by providing
+     * an overload of configEnumValues(T) next to their declaration,
+     * returning all of their values. The first one is used whenever the
+     * configuration contains something unknown.
+     */
+    template <class T>
+    struct ConfigEnumValue {
+        const char *name;
+        T value;
+    };
+
+    template <class T>
+    struct ConfigEnumValues {
+        const ConfigEnumValue<T> *begin;
+        const ConfigEnumValue<T> *end;
+    };
+
+    template <class T>
+    class HasConfigEnumValues {
+        template <class U>
+        static auto test(int) -> decltype(configEnumValues(std::declval<U>()), std::true_type());
+        template <class U>
+        static std::false_type test(...);
+    public:
+        static constexpr bool value = decltype(test<T>(0))::value;
+    };
+
+    /**
+     * Conversion between the values of a ConfigEntry and their textual form.
+     *
+     * parse() reads a single value which has already been stripped of
+     * comments. format() writes into @p out, which is empty on entry and
+     * whose allocation is reused between calls.
+     *
+     * Types without a codec of their own go through their QTextStream
+     * operators.
+     */
+    template <class T, class Enable = void>
+    struct ConfigCodec {
+        static void parse(const QString &str, T &value) {
+            QTextStream in(qPrintable(str));
+            in >> value;
+        }
+        static void format(const T &value, QString &out) {
+            QTextStream stream(&out);
+            stream << value;
+        }
+    };
+
+    template <>
+    struct ConfigCodec<QString> {
+        static void parse(const QString &str, QString &value) {
+            value = str.trimmed();
+        }
+        static void format(const QString &value, QString &out) {
+            out = value;
+        }
+    };
+
+    template <>
+    struct ConfigCodec<QStringList> {
+        static void parse(const QString &str, QStringList &value) {
+            value.clear();
+            const auto strings = str.splitRef(QLatin1Char(','));
+            for (const QStringRef &s : strings) {
+                QStringRef trimmed = s.trimmed();
+                if (!trimmed.isEmpty())
+                    value.append(trimmed.toString());
+            }
+        }
+        static void format(const QStringList &value, QString &out) {
+            for (int i = 0; i < value.size(); ++i) {
+                if (i > 0)
+                    out.append(QLatin1Char(','));
+                out.append(value.at(i));
+            }
+        }
+    };
+
+    template <>
+    struct ConfigCodec<bool> {
+        static void parse(const QString &str, bool &value) {
+            value = QStringRef(&str).trimmed().compare(QLatin1String("true"), Qt::CaseInsensitive) == 0;
+        }
+        static void format(bool value, QString &out) {
+            out.append(value ? QLatin1String("true") : QLatin1String("false"));
+        }
+    };
+
+    template <>
+    struct ConfigCodec<int> {
+        static void parse(const QString &str, int &value) {
+            // the leading number with the 0b, 0x and 0 prefixes, as
+            // QTextStream read it
+            const QStringRef text = QStringRef(&str).trimmed();
+            int pos = 0;
+            const bool negative = text.startsWith(QLatin1Char('-'));
+            if (negative || text.startsWith(QLatin1Char('+')))
+                pos++;
+
+            int base = 10;
+            const QStringRef prefix = text.mid(pos, 2);
+            if (prefix.compare(QLatin1String("0x"), Qt::CaseInsensitive) == 0) {
+                base = 16;
+                pos += 2;
+            } else if (prefix.compare(QLatin1String("0b"), Qt::CaseInsensitive) == 0) {
+                base = 2;
+                pos += 2;
+            } else if (prefix.size() == 2 && prefix.at(0) == QLatin1Char('0')) {
+                base = 8;
+                pos++;
+            }
+
+            // out of range values are clamped to INT_MIN or INT_MAX
+            const qint64 limit = negative ? -qint64(std::numeric_limits<int>::min()) : std::numeric_limits<int>::max();
+            qint64 number = 0;
+            const int start = pos;
+            for (; pos < text.size(); pos++) {
+                const ushort c = text.at(pos).toLower().unicode();
+                const int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'z' ? c - 'a' + 10 : base;
+                if (digit >= base)
+                    break;
+                number = qMin<qint64>(number * base + digit, limit);
+            }
+            value = int(negative ? -number : number);
+
+            if (!text.isEmpty() && (pos == start || pos < text.size()))
+                qWarning() << "Only using the leading number of" << str;
+        }
+        static void format(int value, QString &out) {
+            out.append(QString::number(value));
+        }
+    };
+
+    template <class T>
+    struct ConfigCodec<T, typename std::enable_if<HasConfigEnumValues<T>::value>::type> {
+        static void parse(const QString &str, T &value) {
+            const ConfigEnumValues<T> values = configEnumValues(T());
+            const QStringRef text = QStringRef(&str).trimmed();
+            for (auto it = values.begin; it != values.end; ++it) {
+                if (text.compare(QLatin1String(it->name), Qt::CaseInsensitive) == 0) {
+                    value = it->value;
+                    return;
+                }
+            }
+            value = values.begin->value;
+        }
+        static void format(T value, QString &out) {
+            const ConfigEnumValues<T> values = configEnumValues(T());
+            for (auto it = values.begin; it != values.end; ++it) {
+                if (it->value == value) {
+                    out.append(QLatin1String(it->name));
+                    return;
+                }
+            }
+            out.append(QLatin1String(values.begin->name));
+        }
+    };
 
     class ConfigEntryBase {
     public:
         virtual const QString &name() const = 0;
+        virtual const QString &description() const = 0;
+        virtual ConfigType type() const = 0;
+        virtual QString defaultValue() const = 0;
         virtual QString value() const = 0;
         virtual void setValue(const QString &str) = 0;
         virtual QString toConfigShort() const = 0;
@@ -81,6 +282,8 @@ namespace SDDM {
         virtual bool matchesDefault() const = 0;
         virtual bool isDefault() const = 0;
         virtual bool setDefault() = 0;
+        virtual void rememberValue() = 0;
+        virtual bool notifyIfChanged() = 0;
     };
 
     class ConfigSection {
@@ -111,11 +314,23 @@ namespace SDDM {
             m_description(description),
             m_default(value),
             m_value(value),
+            m_previous(value),
             m_isDefault(true),
             m_parent(parent) {
             m_parent->m_entries[name] = this;
         }
 
+        /**
+         * Calls @p handler with the new value every time a reload changes
+         * this entry, for as long as @p context exists
+         */
+        void onChanged(QObject *context, const std::function<void(const T &)> &handler) {
+            // entries may not change for as long as the daemon runs,
+            // drop the handlers of objects gone in the meantime here too
+            pruneHandlers();
+            m_handlers.append(qMakePair(QPointer<QObject>(context), handler));
+        }
+
         T get() const {
             return m_value;
         }
@@ -123,6 +338,7 @@ namespace SDDM {
         void set(const T val) {
             m_value = val;
             m_isDefault = false;
+            m_formatted = false;
         }
 
         bool matchesDefault() const {
@@ -138,6 +354,7 @@ namespace SDDM {
             if (m_value == m_default)
                 return false;
             m_value = m_default;
+            m_formatted = false;
             return true;
         }
 
@@ -145,22 +362,54 @@ namespace SDDM {
             m_parent->save(this);
         }
 
+        void rememberValue() {
+            m_previous = m_value;
+        }
+
+        bool notifyIfChanged() {
+            if (m_value == m_previous)
+                return false;
+            // handlers may register others or destroy their context
+            const auto handlers = m_handlers;
+            for (const auto &handler : handlers) {
+                if (!handler.first.isNull())
+                    handler.second(m_value);
+            }
+            pruneHandlers();
+            return true;
+        }
+
         const QString &name() const {
             return m_name;
         }
 
-        QString value() const {
+        const QString &description() const {
+            return m_description;
+        }
+
+        ConfigType type() const {
+            return configType<T>();
+        }
+
+        QString defaultValue() const {
             QString str;
-            QTextStream out(&str);
-            out << m_value;
+            ConfigCodec<T>::format(m_default, str);
             return str;
         }
 
-        // specialised for QString
+        QString value() const {
+            if (!m_formatted) {
+                m_text.truncate(0);
+                ConfigCodec<T>::format(m_value, m_text);
+                m_formatted = true;
+            }
+            return m_text;
+        }
+
         void setValue(const QString &str) {
             m_isDefault = false;
-            QTextStream in(qPrintable(str));
-            in >> m_value;
+            m_formatted = false;
+            ConfigCodec<T>::parse(str, m_value);
         }
 
         QString toConfigShort() const {
@@ -175,12 +424,138 @@ namespace SDDM {
             return str;
         }
     private:
+        void pruneHandlers() {
+            for (auto it = m_handlers.begin(); it != m_handlers.end(); ) {
+                if (it->first.isNull())
+                    it = m_handlers.erase(it);
+                else
+                    ++it;
+            }
+        }
+
         const QString m_name;
         const QString m_description;
         T m_default;
         T m_value;
+        T m_previous;
+        // textual form of m_value, formatted on demand
+        mutable QString m_text;
+        mutable bool m_formatted { false };
         bool m_isDefault;
         ConfigSection *m_parent;
+        QVector<QPair<QPointer<QObject>, std::function<void(const T &)>>> m_handlers;
+    };
+
+    /**
+     * Binary cache of the values parsed from all configuration files.
+     *
+     * The snapshot is keyed by device, inode, size and modification time of
+     * every input file. As long as none of them changes, every process using
+     * the same configuration maps the snapshot instead of parsing the text
+     * files again.
+     */
+    class ConfigSnapshot {
+    public:
+        ConfigSnapshot(ConfigBase *parent, const QString &path);
+
+        struct Input {
+            QByteArray path;
+            bool exists { false };
+            quint64 device { 0 };
+            quint64 inode { 0 };
+            qint64 size { 0 };
+            qint64 modified { 0 };
+
+            bool operator==(const Input &o) const {
+                return path == o.path && exists == o.exists && device == o.device &&
+                       inode == o.inode && size == o.size && modified == o.modified;
+            }
+            bool operator!=(const Input &o) const { return !(*this == o); }
+        };
+
+        struct Assignment {
+            QString section;
+            QString entry;
+            QString value;
+        };
+
+        static Input stat(const QString &path);
+    };
+
+    /**
+     * Append-only journal of the values saved by this process.
+     *
+     * save() appends the entries which changed since the last load or
+     * save to "<path>.journal" instead of rewriting the configuration file.
+     * A worker thread writes the records and syncs them in batches. Once
+     * the journal grows too large, its values are merged into the
+     * configuration file, which is atomically replaced, and the journal is
+     * truncated. Comments and unknown sections or keys in the file stay.
+     */
+    class ConfigJournal {
+    public:
+        explicit ConfigJournal(ConfigBase *parent);
+        ~ConfigJournal();
+
+        void append(const QByteArray &record);
+        void flush();
+    private:
+        class Writer;
+
+        ConfigBase *m_parent { nullptr };
+        Writer *m_writer { nullptr };
+    };
+
+    /**
+     * Static description of all sections and entries of a Config.
+     *
+     * The schema is created once per Config class from a prototype which
+     * doesn't read any file. Sections and entries are numbered in the
+     * order the Config iterates them, and both are looked up through
+     * collision-free hash tables, so finding an entry by its name costs a
+     * single hash and comparison without allocating anything.
+     */
+    class ConfigSchema {
+    public:
+        // tag for the constructor of a Config which doesn't load anything
+        struct Prototype { };
+
+        struct SectionInfo {
+            QString name;
+            int firstEntry;
+            int entryCount;
+        };
+
+        struct EntryInfo {
+            int section;
+            QString name;
+            ConfigType type;
+            QString defaultValue;
+            QString description;
+        };
+
+        explicit ConfigSchema(const ConfigBase &prototype);
+
+        const QVector<SectionInfo> &sections() const;
+        const QVector<EntryInfo> &entries() const;
+
+        // both return -1 for unknown names
+        int sectionId(const QStringRef &name) const;
+        int entryId(int section, const QStringRef &name) const;
+
+        // complete configuration with all values set to their defaults
+        QString toConfigFull() const;
+
+        struct Table {
+            uint seed;
+            uint mask;
+            QVector<int> buckets;
+        };
+    private:
+        QVector<SectionInfo> m_sections;
+        QVector<EntryInfo> m_entries;
+        Table m_sectionTable;
+        QVector<Table> m_entryTables;
     };
 
     // Base has to be separate from the Config itself - order of initialization
@@ -189,11 +564,16 @@ namespace SDDM {
         ConfigBase(const QString &configPath, const QString &configDir=QString(), const QString &sysConfigDir=QString());
 
         void load();
+        bool reload();
         void save(const ConfigSection *section = nullptr, const ConfigEntryBase *entry = nullptr);
+        // waits until everything saved through a journal is on disk
+        void flush();
         void wipe();
         bool hasUnused() const;
         QString toConfigFull() const;
     protected:
+        void setSchema(const ConfigSchema *schema);
+
         bool m_unusedVariables { false };
         bool m_unusedSections { false };
 
@@ -202,10 +582,27 @@ namespace SDDM {
         QString m_sysConfigDir;
         QMap<QString, ConfigSection*> m_sections;
         friend class ConfigSection;
+        friend class ConfigSnapshot;
+        friend class ConfigJournal;
+        friend class ConfigSchema;
+        friend class ConfigWatcher;
     private:
         QDateTime dirLatestModifiedTime(const QString &directory);
-        void loadInternal(const QString &filepath);
+        void loadFiles();
+        void saveJournal();
+        void loadInternal(const QString &filepath, QVector<ConfigSnapshot::Assignment> *assignments = nullptr);
+        QVector<ConfigSnapshot::Input> snapshotInputs(const QStringList &files) const;
+        bool loadSnapshot(const QVector<ConfigSnapshot::Input> &inputs);
+        void saveSnapshot(const QVector<ConfigSnapshot::Input> &inputs, const QVector<ConfigSnapshot::Assignment> &assignments) const;
         QDateTime m_fileModificationTime;
+        QString m_snapshotPath;
+        QString m_journalPath;
+        ConfigJournal *m_journal { nullptr };
+        // values as last loaded or appended to the journal, indexed like m_entryTable
+        QVector<QString> m_journaled;
+        const ConfigSchema *m_schema { nullptr };
+        // live entries, indexed by their id in the schema
+        QVector<ConfigEntryBase *> m_entryTable;
     };
 }
 
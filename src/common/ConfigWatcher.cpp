@@ -0,0 +1,107 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "ConfigWatcher.h"
+
+#include "ConfigReader.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+namespace SDDM {
+    ConfigWatcher::ConfigWatcher(ConfigBase *config, QObject *parent) : QObject(parent),
+        m_config(config),
+        m_watcher(new QFileSystemWatcher(this)),
+        m_timer(new QTimer(this)) {
+        // editors usually touch a file several times while saving it
+        m_timer->setSingleShot(true);
+        m_timer->setInterval(250);
+        connect(m_timer, &QTimer::timeout, this, &ConfigWatcher::reload);
+
+        connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ConfigWatcher::fileChanged);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_timer, QOverload<>::of(&QTimer::start));
+
+        updatePaths();
+    }
+
+    void ConfigWatcher::fileChanged(const QString &path) {
+        // a file replaced by renaming another one over it is no longer
+        // watched
+        if (QFileInfo::exists(path) && !m_watcher->files().contains(path))
+            m_watcher->addPath(path);
+        m_timer->start();
+    }
+
+    void ConfigWatcher::reload() {
+        // files replaced by renaming them are no longer watched
+        updatePaths();
+
+        if (m_config->reload()) {
+            qDebug() << "Configuration changed on disk, reloaded";
+            emit changed();
+        }
+    }
+
+    void ConfigWatcher::updatePaths() {
+        QStringList paths;
+        auto addPath = [&paths](const QString &path) {
+            if (!path.isEmpty() && QFileInfo::exists(path))
+                paths << path;
+        };
+
+        // the parent of the main file is /etc, which changes all the
+        // time, so it is only watched until the file shows up
+        if (QFileInfo::exists(m_config->m_path))
+            addPath(m_config->m_path);
+        else
+            addPath(QFileInfo(m_config->m_path).absolutePath());
+
+        for (const QString &directory : { m_config->m_sysConfigDir, m_config->m_configDir }) {
+            if (directory.isEmpty())
+                continue;
+            addPath(directory);
+
+            const QDir dir(directory);
+            const auto files = dir.entryList(QDir::Files | QDir::NoDotAndDotDot);
+            for (const QString &file : files)
+                addPath(dir.absoluteFilePath(file));
+        }
+
+        const QStringList watched = m_watcher->files() + m_watcher->directories();
+
+        QStringList removed;
+        for (const QString &path : watched) {
+            if (!paths.contains(path))
+                removed << path;
+        }
+        if (!removed.isEmpty())
+            m_watcher->removePaths(removed);
+
+        QStringList added;
+        for (const QString &path : qAsConst(paths)) {
+            if (!watched.contains(path))
+                added << path;
+        }
+        if (!added.isEmpty())
+            m_watcher->addPaths(added);
+    }
+}
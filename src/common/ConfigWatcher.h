@@ -0,0 +1,59 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_CONFIGWATCHER_H
+#define SDDM_CONFIGWATCHER_H
+
+#include <QObject>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace SDDM {
+    class ConfigBase;
+
+    /**
+     * Reloads a configuration whenever one of its files or directories
+     * changes on disk.
+     *
+     * Changed entries notify their handlers, see ConfigEntry::onChanged().
+     */
+    class ConfigWatcher : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(ConfigWatcher)
+    public:
+        explicit ConfigWatcher(ConfigBase *config, QObject *parent = nullptr);
+
+    signals:
+        void changed();
+
+    private slots:
+        void fileChanged(const QString &path);
+        void reload();
+
+    private:
+        void updatePaths();
+
+        ConfigBase *m_config { nullptr };
+        QFileSystemWatcher *m_watcher { nullptr };
+        QTimer *m_timer { nullptr };
+    };
+}
+
+#endif // SDDM_CONFIGWATCHER_H
@@ -36,6 +36,8 @@ namespace SDDM {
     Config(MainConfig, QStringLiteral(CONFIG_FILE), QStringLiteral(CONFIG_DIR), QStringLiteral(SYSTEM_CONFIG_DIR),
         enum NumState { NUM_NONE, NUM_SET_ON, NUM_SET_OFF };
 
+        Snapshot(_S(RUNTIME_DIR "/sddm.conf.snapshot"))
+
         //  Name                   Type         Default value                                   Description
         // TODO: Change default to x11-user in a future release
         Entry(DisplayServer,       QString,     _S("x11"),                                      _S("Which display server should be used.\n"
@@ -48,6 +50,9 @@ namespace SDDM {
         Entry(InputMethod,         QString,     QStringLiteral("qtvirtualkeyboard"),                   _S("Input method module"));
         Entry(Namespaces,          QStringList, QStringList(),                                  _S("Comma-separated list of Linux namespaces for user session to enter"));
         Entry(GreeterEnvironment,  QStringList, QStringList(),                                  _S("Comma-separated list of environment variables to be set"));
+        Entry(PrestartHelper,      bool,        true,                                           _S("Keep an authentication helper started on each seat to speed up logins"));
+        Entry(StandbyGreeter,      bool,        false,                                          _S("Keep a greeter loaded in the background while a user session runs,\n"
+                                                                                                   "so that it shows up right away on logout. Only with DisplayServer=x11"));
         //  Name   Entries (but it's a regular class again)
         Section(Theme,
             Entry(ThemeDir,            QString,     _S(DATA_INSTALL_DIR "/themes"),             _S("Theme directory path"));
@@ -67,13 +72,16 @@ namespace SDDM {
             Entry(ServerPath,          QString,     _S("/usr/bin/X"),                           _S("Path to X server binary"));
             Entry(ServerArguments,     QString,     _S("-nolisten tcp"),                        _S("Arguments passed to the X server invocation"));
             Entry(XephyrPath,          QString,     _S("/usr/bin/Xephyr"),                      _S("Path to Xephyr binary"));
-            Entry(XauthPath,           QString,     _S("/usr/bin/xauth"),                       _S("Path to xauth binary"));
+            Entry(XauthPath,           QString,     _S("/usr/bin/xauth"),                       _S("Deprecated and ignored, the Xauthority files are written directly"));
             Entry(SessionDir,          QString,     _S("/usr/share/xsessions"),                 _S("Directory containing available X sessions"));
             Entry(SessionCommand,      QString,     _S(SESSION_COMMAND),                        _S("Path to a script to execute when starting the desktop session"));
 	    Entry(SessionLogFile,      QString,     _S(".local/share/sddm/xorg-session.log"),   _S("Path to the user session log file"));
 	    Entry(UserAuthFile,        QString,     _S(".Xauthority"),                          _S("Path to the Xauthority file"));
             Entry(DisplayCommand,      QString,     _S(DATA_INSTALL_DIR "/scripts/Xsetup"),     _S("Path to a script to execute when starting the display server"));
+            Entry(DisplayCommandTimeout, int,       30,                                         _S("Seconds the display setup script may run before it is killed"));
+            Entry(DisplayCommandBlocking, bool,     true,                                       _S("Wait for the display setup script before starting the greeter"));
             Entry(DisplayStopCommand,  QString,     _S(DATA_INSTALL_DIR "/scripts/Xstop"),      _S("Path to a script to execute when stopping the display server"));
+            Entry(DisplayStopCommandTimeout, int,   5,                                          _S("Seconds the display stop script may run before it is killed"));
             Entry(EnableHiDPI,         bool,        false,                                      _S("Enable Qt's automatic high-DPI scaling"));
         );
 
@@ -92,6 +100,8 @@ namespace SDDM {
             Entry(HideUsers,           QStringList, QStringList(),                              _S("Comma-separated list of users that should not be listed"));
             Entry(HideShells,          QStringList, QStringList(),                              _S("Comma-separated list of shells.\n"
                                                                                                    "Users with these shells as their default won't be listed"));
+            Entry(RefreshInterval,     int,         600,                                        _S("Seconds between background rescans of the user database for the user list.\n"
+                                                                                                   "Changes of /etc/passwd are picked up right away. 0 disables the rescans"));
             Entry(RememberLastUser,    bool,        true,                                       _S("Remember the last successfully logged in user"));
             Entry(RememberLastSession, bool,        true,                                       _S("Remember the session of the last successfully logged in user"));
 
@@ -106,6 +116,9 @@ namespace SDDM {
     );
 
     Config(StateConfig, []()->QString{auto tmp = getpwnam("sddm"); return tmp ? QString::fromLocal8Bit(tmp->pw_dir) : QStringLiteral(STATE_DIR);}().append(QStringLiteral("/state.conf")), QString(), QString(),
+        Snapshot(_S(RUNTIME_DIR "/state.conf.snapshot"))
+        Journal()
+
         Section(Last,
             Entry(Session,         QString,     QString(),                                      _S("Name of the session for the last logged-in user.\n"
                                                                                                    "This session will be preselected when the login screen appears."));
@@ -117,25 +130,13 @@ namespace SDDM {
     extern MainConfig mainConfig;
     extern StateConfig stateConfig;
 
-    inline QTextStream& operator>>(QTextStream &str, MainConfig::NumState &state) {
-        QString text = str.readLine().trimmed();
-        if (text.compare(QLatin1String("on"), Qt::CaseInsensitive) == 0)
-            state = MainConfig::NUM_SET_ON;
-        else if (text.compare(QLatin1String("off"), Qt::CaseInsensitive) == 0)
-            state = MainConfig::NUM_SET_OFF;
-        else
-            state = MainConfig::NUM_NONE;
-        return str;
-    }
-
-    inline QTextStream& operator<<(QTextStream &str, const MainConfig::NumState &state) {
-        if (state == MainConfig::NUM_SET_ON)
-            str << "on";
-        else if (state == MainConfig::NUM_SET_OFF)
-            str << "off";
-        else
-            str << "none";
-        return str;
+    inline ConfigEnumValues<MainConfig::NumState> configEnumValues(MainConfig::NumState) {
+        static const ConfigEnumValue<MainConfig::NumState> values[] = {
+            { "none", MainConfig::NUM_NONE },
+            { "on",   MainConfig::NUM_SET_ON },
+            { "off",  MainConfig::NUM_SET_OFF },
+        };
+        return { std::begin(values), std::end(values) };
     }
 }
 
@@ -0,0 +1,159 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "EnvironmentTemplate.h"
+
+#include "Configuration.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTextStream>
+
+#define LOCALE_CONF "/etc/locale.conf"
+
+namespace SDDM {
+    namespace {
+        struct LocaleLayer {
+            QFileSystemWatcher *watcher { nullptr };
+            QProcessEnvironment environment;
+            bool valid { false };
+        };
+
+        LocaleLayer &localeLayer() {
+            static LocaleLayer layer;
+            return layer;
+        }
+
+        void watchLocale() {
+            LocaleLayer &layer = localeLayer();
+            // the file itself, its directory only until it shows up. A
+            // replaced file is no longer watched.
+            const QString path = QStringLiteral(LOCALE_CONF);
+            const QString dir = QFileInfo(path).absolutePath();
+            if (QFileInfo::exists(path)) {
+                if (!layer.watcher->files().contains(path))
+                    layer.watcher->addPath(path);
+                if (layer.watcher->directories().contains(dir))
+                    layer.watcher->removePath(dir);
+            } else if (!layer.watcher->directories().contains(dir)) {
+                layer.watcher->addPath(dir);
+            }
+        }
+
+        void readLocale() {
+            LocaleLayer &layer = localeLayer();
+            QProcessEnvironment env;
+            bool langEmpty = true;
+            QFile localeFile(QStringLiteral(LOCALE_CONF));
+            if (localeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                QTextStream in(&localeFile);
+                while (!in.atEnd()) {
+                    QStringList parts = in.readLine().split(QLatin1Char('='));
+                    if (parts.size() >= 2) {
+                        env.insert(parts[0], parts[1]);
+                        if (parts[0] == QLatin1String("LANG"))
+                            langEmpty = false;
+                    }
+                }
+                localeFile.close();
+            }
+            if (langEmpty)
+                env.insert(QStringLiteral("LANG"), QStringLiteral("C"));
+
+            layer.environment = env;
+            layer.valid = true;
+        }
+    }
+
+    EnvironmentTemplate::EnvironmentTemplate(const QString &seat, const QString &seatPath, QObject *parent) : QObject(parent),
+        m_seat(seat),
+        m_seatPath(seatPath) {
+        mainConfig.Users.DefaultPath.onChanged(this, [this](const QString &) {
+            m_valid = false;
+        });
+    }
+
+    QProcessEnvironment EnvironmentTemplate::locale() {
+        LocaleLayer &layer = localeLayer();
+
+        if (!layer.watcher) {
+            layer.watcher = new QFileSystemWatcher(QCoreApplication::instance());
+            QObject::connect(layer.watcher, &QFileSystemWatcher::fileChanged, [](const QString &) {
+                localeLayer().valid = false;
+                watchLocale();
+            });
+            // only the file being created matters
+            QObject::connect(layer.watcher, &QFileSystemWatcher::directoryChanged, [](const QString &) {
+                if (!QFileInfo::exists(QStringLiteral(LOCALE_CONF)))
+                    return;
+                localeLayer().valid = false;
+                watchLocale();
+            });
+            watchLocale();
+        }
+
+        if (!layer.valid)
+            readLocale();
+        return layer.environment;
+    }
+
+    QProcessEnvironment EnvironmentTemplate::greeter() const {
+        if (!m_valid)
+            update();
+        return m_greeter;
+    }
+
+    QProcessEnvironment EnvironmentTemplate::session() const {
+        if (!m_valid)
+            update();
+        return m_session;
+    }
+
+    void EnvironmentTemplate::update() const {
+        QProcessEnvironment session;
+        session.insert(QStringLiteral("PATH"), mainConfig.Users.DefaultPath.get());
+        session.insert(QStringLiteral("XDG_SEAT"), m_seat);
+        session.insert(QStringLiteral("XDG_SEAT_PATH"), m_seatPath);
+
+        // what the greeter needs to find its locale, libraries and plugins
+        static const QString inherited[] = {
+            QStringLiteral("LANG"), QStringLiteral("LANGUAGE"),
+            QStringLiteral("LC_CTYPE"), QStringLiteral("LC_NUMERIC"), QStringLiteral("LC_TIME"), QStringLiteral("LC_COLLATE"),
+            QStringLiteral("LC_MONETARY"), QStringLiteral("LC_MESSAGES"), QStringLiteral("LC_PAPER"), QStringLiteral("LC_NAME"),
+            QStringLiteral("LC_ADDRESS"), QStringLiteral("LC_TELEPHONE"), QStringLiteral("LC_MEASUREMENT"), QStringLiteral("LC_IDENTIFICATION"),
+            QStringLiteral("LD_LIBRARY_PATH"),
+            QStringLiteral("QML2_IMPORT_PATH"),
+            QStringLiteral("QT_PLUGIN_PATH"),
+            QStringLiteral("XDG_DATA_DIRS")
+        };
+        const QProcessEnvironment sysenv = QProcessEnvironment::systemEnvironment();
+        QProcessEnvironment greeter;
+        for (const QString &name : inherited) {
+            if (sysenv.contains(name))
+                greeter.insert(name, sysenv.value(name));
+        }
+        greeter.insert(session);
+
+        m_greeter = greeter;
+        m_session = session;
+        m_valid = true;
+    }
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_ENVIRONMENTTEMPLATE_H
+#define SDDM_ENVIRONMENTTEMPLATE_H
+
+#include <QObject>
+#include <QProcessEnvironment>
+
+namespace SDDM {
+    /**
+     * The environments of the processes started for a seat, assembled
+     * from layers that are computed once and kept until their input
+     * changes:
+     *
+     *  - the locale layer, read from /etc/locale.conf and shared by all
+     *    seats, reread only after the file changed on disk
+     *  - the seat layer with the variables every greeter and session on
+     *    the seat gets
+     *
+     * The environments returned are implicitly shared: a caller adding
+     * the variables of one particular greeter or session copies it only
+     * then, the template itself stays untouched.
+     */
+    class EnvironmentTemplate : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(EnvironmentTemplate)
+    public:
+        EnvironmentTemplate(const QString &seat, const QString &seatPath, QObject *parent = nullptr);
+
+        /**
+         * The environment sddm-helper is started with, the contents of
+         * /etc/locale.conf and LANG=C if that doesn't set it.
+         */
+        static QProcessEnvironment locale();
+
+        /**
+         * Base environment of a greeter on this seat.
+         */
+        QProcessEnvironment greeter() const;
+
+        /**
+         * Base environment of a user session on this seat.
+         */
+        QProcessEnvironment session() const;
+
+    private:
+        void update() const;
+
+        QString m_seat;
+        QString m_seatPath;
+
+        mutable bool m_valid { false };
+        mutable QProcessEnvironment m_greeter;
+        mutable QProcessEnvironment m_session;
+    };
+}
+
+#endif // SDDM_ENVIRONMENTTEMPLATE_H
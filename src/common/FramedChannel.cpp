@@ -0,0 +1,137 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "FramedChannel.h"
+
+#include <QDebug>
+#include <QIODevice>
+#include <QPointer>
+#include <QTimer>
+
+#include <string.h>
+
+// frames are tiny, anything bigger means the stream is out of sync
+#define MAX_FRAME_SIZE (16 * 1024 * 1024)
+// default time a started frame has to be completed in
+#define FRAME_TIMEOUT 30000
+
+namespace SDDM {
+    FramedChannel::FramedChannel(QIODevice *device, QObject *parent)
+        : QObject(parent)
+        , m_device(device)
+        , m_timer(new QTimer(this)) {
+        m_timer->setSingleShot(true);
+        m_timer->setInterval(FRAME_TIMEOUT);
+        connect(m_timer, &QTimer::timeout, this, &FramedChannel::timedOut);
+        connect(m_device, &QIODevice::readyRead, this, &FramedChannel::readData);
+        connect(m_device, &QIODevice::bytesWritten, this, &FramedChannel::writeData);
+
+        // the device may have received something before we got it
+        if (m_device->bytesAvailable() > 0)
+            QTimer::singleShot(0, this, &FramedChannel::readData);
+    }
+
+    QIODevice *FramedChannel::device() const {
+        return m_device;
+    }
+
+    void FramedChannel::setTimeout(int msec) {
+        m_timer->setInterval(msec);
+    }
+
+    void FramedChannel::setPacketMode(bool packets) {
+        m_packets = packets;
+    }
+
+    void FramedChannel::send(const QByteArray &payload) {
+        const qint64 length = payload.size();
+        m_output.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        m_output.append(payload);
+
+        // cork until the current event loop iteration is done
+        if (!m_flushPending) {
+            m_flushPending = true;
+            QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+        }
+    }
+
+    void FramedChannel::flush() {
+        m_flushPending = false;
+        writeData();
+    }
+
+    void FramedChannel::readData() {
+        m_input.append(m_device->readAll());
+
+        // signal handlers are free to delete us
+        QPointer<FramedChannel> self(this);
+        while (m_input.size() >= int(sizeof(qint64))) {
+            qint64 length = 0;
+            memcpy(&length, m_input.constData(), sizeof(length));
+            if (length < 0 || length > MAX_FRAME_SIZE) {
+                qCritical() << "FramedChannel: Invalid frame length" << length;
+                m_input.clear();
+                m_timer->stop();
+                emit timedOut();
+                return;
+            }
+            if (m_input.size() < int(sizeof(qint64) + length))
+                break;
+
+            const QByteArray payload = m_input.mid(sizeof(qint64), int(length));
+            m_input.remove(0, int(sizeof(qint64) + length));
+            // the next frame gets a timeout of its own
+            m_timer->stop();
+            emit frameReceived(payload);
+            if (!self)
+                return;
+        }
+
+        updateTimer();
+    }
+
+    void FramedChannel::writeData() {
+        // keep a single chunk in the device buffer at a time
+        if (!m_output.isEmpty() && m_device->bytesToWrite() == 0) {
+            qint64 size = m_output.size();
+            if (m_packets) {
+                memcpy(&size, m_output.constData(), sizeof(size));
+                size += sizeof(qint64);
+            }
+            const qint64 written = m_device->write(m_output.constData(), size);
+            if (written < 0) {
+                qCritical() << "FramedChannel: Could not write to the device:" << m_device->errorString();
+                m_output.clear();
+            } else {
+                m_output.remove(0, int(written));
+            }
+        }
+
+        updateTimer();
+    }
+
+    void FramedChannel::updateTimer() {
+        // only a frame in flight may time out, waiting for the next one is fine
+        const bool pending = !m_input.isEmpty() || !m_output.isEmpty() || m_device->bytesToWrite() > 0;
+        if (!pending)
+            m_timer->stop();
+        else if (!m_timer->isActive())
+            m_timer->start();
+    }
+}
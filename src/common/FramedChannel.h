@@ -0,0 +1,82 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_FRAMEDCHANNEL_H
+#define SDDM_FRAMEDCHANNEL_H
+
+#include <QObject>
+#include <QByteArray>
+
+class QIODevice;
+class QTimer;
+
+namespace SDDM {
+    /**
+     * Event driven transport for the frames of SafeDataStream and of the
+     * greeter protocol.
+     *
+     * Every frame is a native qint64 length followed by the payload.
+     * Incoming data is collected per channel and decoded as it arrives,
+     * however it was split or coalesced on the way. Outgoing frames are
+     * corked: everything sent during one event loop iteration is handed
+     * to the device in a single write once control returns to the event
+     * loop, or when the device has written the previous ones. Nothing
+     * ever waits on the device. In packet mode each frame gets a write of
+     * its own instead, so that a SOCK_SEQPACKET socket carries it as one
+     * packet.
+     *
+     * A frame which has been started but isn't completely received or
+     * written within the timeout makes the channel emit timedOut().
+     */
+    class FramedChannel : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(FramedChannel)
+    public:
+        explicit FramedChannel(QIODevice *device, QObject *parent = nullptr);
+
+        QIODevice *device() const;
+
+        void setTimeout(int msec);
+
+        void setPacketMode(bool packets);
+
+        void send(const QByteArray &payload);
+
+    signals:
+        void frameReceived(const QByteArray &payload);
+        void timedOut();
+
+    private slots:
+        void readData();
+        void writeData();
+        void flush();
+
+    private:
+        void updateTimer();
+
+        QIODevice *m_device { nullptr };
+        QTimer *m_timer { nullptr };
+        QByteArray m_input;
+        QByteArray m_output;
+        bool m_flushPending { false };
+        bool m_packets { false };
+    };
+}
+
+#endif // SDDM_FRAMEDCHANNEL_H
@@ -0,0 +1,175 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "HookRunner.h"
+
+#include <QDebug>
+#include <QEventLoop>
+#include <QTimer>
+
+namespace SDDM {
+    HookRunner::HookRunner(QObject *parent) : QObject(parent),
+        m_timer(new QTimer(this)) {
+        m_timer->setSingleShot(true);
+        connect(m_timer, &QTimer::timeout, this, &HookRunner::timedOut);
+    }
+
+    HookRunner::~HookRunner() {
+        // don't leave a script behind
+        if (m_process) {
+            m_process->disconnect(this);
+            m_process->kill();
+            m_process->waitForFinished(1000);
+        }
+    }
+
+    void HookRunner::setProcessEnvironment(const QProcessEnvironment &env) {
+        m_environment = env;
+    }
+
+    void HookRunner::add(const QString &name, const QString &command, int timeout, bool blocking) {
+        if (!QProcess::splitCommand(command).isEmpty()) {
+            m_queue.enqueue({ name, command, timeout, blocking });
+            if (blocking)
+                m_blocking++;
+        }
+
+        // start from the event loop, so that the caller can connect first
+        if (!m_process && !m_scheduled) {
+            m_scheduled = true;
+            QMetaObject::invokeMethod(this, "next", Qt::QueuedConnection);
+        }
+    }
+
+    bool HookRunner::isReady() const {
+        return m_blocking == 0;
+    }
+
+    bool HookRunner::isFinished() const {
+        return !m_process && m_queue.isEmpty();
+    }
+
+    void HookRunner::waitForReady() {
+        if (isReady())
+            return;
+
+        QEventLoop loop;
+        connect(this, &HookRunner::ready, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    void HookRunner::waitForFinished() {
+        if (isFinished())
+            return;
+
+        QEventLoop loop;
+        connect(this, &HookRunner::finished, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    void HookRunner::next() {
+        m_scheduled = false;
+
+        if (m_process)
+            return;
+
+        if (m_queue.isEmpty()) {
+            emit finished();
+            return;
+        }
+
+        m_current = m_queue.dequeue();
+        m_timedOut = false;
+
+        QStringList args = QProcess::splitCommand(m_current.command);
+        const QString program = args.takeFirst();
+
+        m_process = new QProcess(this);
+        m_process->setProcessEnvironment(m_environment);
+        m_process->setProcessChannelMode(QProcess::MergedChannels);
+        m_process->setStandardInputFile(QProcess::nullDevice());
+        connect(m_process, &QProcess::readyReadStandardOutput, this, &HookRunner::readOutput);
+        connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &HookRunner::processFinished);
+        connect(m_process, &QProcess::errorOccurred, this, &HookRunner::processError);
+
+        qDebug() << "Running" << m_current.name << m_current.command;
+        m_timer->start(m_current.timeout);
+        m_process->start(program, args);
+    }
+
+    void HookRunner::readOutput() {
+        if (!m_process)
+            return;
+
+        while (m_process->canReadLine()) {
+            const QByteArray line = m_process->readLine().trimmed();
+            if (!line.isEmpty())
+                qInfo().noquote() << m_current.name << "|" << QString::fromLocal8Bit(line);
+        }
+    }
+
+    void HookRunner::processFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+        // whatever is left without a newline
+        readOutput();
+        const QByteArray rest = m_process->readAll().trimmed();
+        if (!rest.isEmpty())
+            qInfo().noquote() << m_current.name << "|" << QString::fromLocal8Bit(rest);
+
+        const bool success = !m_timedOut && exitStatus == QProcess::NormalExit && exitCode == 0;
+        if (!success && !m_timedOut)
+            qWarning() << m_current.name << "exited with status" << exitCode;
+
+        done(success);
+    }
+
+    void HookRunner::processError(QProcess::ProcessError error) {
+        // anything else ends in finished()
+        if (error != QProcess::FailedToStart)
+            return;
+
+        qWarning() << "Failed to run" << m_current.name << m_current.command << ":" << m_process->errorString();
+        done(false);
+    }
+
+    void HookRunner::timedOut() {
+        if (!m_process)
+            return;
+
+        qWarning() << m_current.name << "did not finish within" << m_current.timeout << "ms, killing it";
+        m_timedOut = true;
+        m_process->kill();
+    }
+
+    void HookRunner::done(bool success) {
+        m_timer->stop();
+        m_process->disconnect(this);
+        m_process->deleteLater();
+        m_process = nullptr;
+
+        const Hook hook = m_current;
+        if (hook.blocking)
+            m_blocking--;
+
+        emit hookFinished(hook.name, success);
+        if (hook.blocking && m_blocking == 0)
+            emit ready();
+
+        next();
+    }
+}
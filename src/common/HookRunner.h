@@ -0,0 +1,93 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_HOOKRUNNER_H
+#define SDDM_HOOKRUNNER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+
+class QTimer;
+
+namespace SDDM {
+    /**
+     * Runs site scripts such as Xsetup and Xstop without waiting for them.
+     *
+     * Hooks run one after another in the order they were added, each with
+     * its own timeout after which it is killed. Their output goes to the
+     * log line by line. ready() is emitted once no blocking hook is left,
+     * so whatever depends on them can go ahead while non-blocking hooks are
+     * still running; finished() follows when the queue is empty.
+     */
+    class HookRunner : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(HookRunner)
+    public:
+        explicit HookRunner(QObject *parent = nullptr);
+        ~HookRunner();
+
+        void setProcessEnvironment(const QProcessEnvironment &env);
+
+        // timeout is in milliseconds, empty commands are skipped but
+        // finished() is still emitted
+        void add(const QString &name, const QString &command, int timeout, bool blocking = true);
+
+        bool isReady() const;
+        bool isFinished() const;
+
+        // spins a local event loop, for processes that have nothing
+        // else to do in the meantime
+        void waitForReady();
+        void waitForFinished();
+
+    signals:
+        void hookFinished(const QString &name, bool success);
+        void ready();
+        void finished();
+
+    private slots:
+        void next();
+        void readOutput();
+        void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+        void processError(QProcess::ProcessError error);
+        void timedOut();
+
+    private:
+        struct Hook {
+            QString name;
+            QString command;
+            int timeout;
+            bool blocking;
+        };
+
+        void done(bool success);
+
+        QProcessEnvironment m_environment;
+        QQueue<Hook> m_queue;
+        Hook m_current;
+        QProcess *m_process { nullptr };
+        QTimer *m_timer { nullptr };
+        int m_blocking { 0 };
+        bool m_scheduled { false };
+        bool m_timedOut { false };
+    };
+}
+
+#endif // SDDM_HOOKRUNNER_H
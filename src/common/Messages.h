@@ -30,14 +30,18 @@ namespace SDDM {
         Reboot,
         Suspend,
         Hibernate,
-        HybridSleep
+        HybridSleep,
+        ListUsers
     };
 
     enum class DaemonMessages {
         HostName,
         Capabilities,
         LoginSucceeded,
-        LoginFailed
+        LoginFailed,
+        UserPage,
+        UsersAdded,
+        UsersRemoved
     };
 
     enum Capability {
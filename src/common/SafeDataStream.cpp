@@ -34,9 +34,12 @@ namespace SDDM {
             qCritical() << " Auth: SafeDataStream: Could not write any data";
             return;
         }
-        m_device->write((const char*) &length, sizeof(length));
+        // one write for the whole frame, a SOCK_SEQPACKET socket carries it as one packet
+        QByteArray frame((const char*) &length, sizeof(length));
+        frame.append(m_data);
+        length = frame.length();
         while (writtenTotal != length) {
-            qint64 written = m_device->write(m_data.mid(writtenTotal));
+            qint64 written = m_device->write(frame.mid(writtenTotal));
             if (written < 0 || !m_device->isOpen()) {
                 qCritical() << " Auth: SafeDataStream: Could not write all stored data";
                 return;
@@ -48,6 +51,16 @@ namespace SDDM {
         reset();
     }
 
+    void SafeDataStream::send(const QByteArray &frame) {
+        reset();
+        m_data = frame;
+        send();
+    }
+
+    const QByteArray &SafeDataStream::frame() const {
+        return m_data;
+    }
+
     void SafeDataStream::receive() {
         qint64 length = -1;
 
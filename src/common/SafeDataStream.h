@@ -28,9 +28,13 @@ namespace SDDM {
     public:
         SafeDataStream(QIODevice* device);
         void send();
+        void send(const QByteArray &frame);
         void receive();
         void reset();
 
+        // contents of the last received frame
+        const QByteArray &frame() const;
+
     private:
         QByteArray m_data { };
         QIODevice *m_device { nullptr };
@@ -18,8 +18,11 @@
 * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 ***************************************************************************/
 
+#include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QTextStream>
 
 #include "Configuration.h"
@@ -28,12 +31,44 @@
 const QString s_entryExtention = QStringLiteral(".desktop");
 
 namespace SDDM {
+    struct Session::Entry {
+        bool valid { false };
+        Type type { UnknownSession };
+        QDir dir;
+        QString fileName;
+        QString displayName;
+        QString comment;
+        QString exec;
+        QString tryExec;
+        QString xdgSessionType;
+        QString desktopNames;
+        QProcessEnvironment additionalEnv;
+        bool isHidden { false };
+        bool isNoDisplay { false };
+    };
+
+    namespace {
+        QProcessEnvironment parseEnv(const QString &fileName, const QString &list)
+        {
+            QProcessEnvironment env;
+
+            const QVector<QStringRef> entryList = list.splitRef(QLatin1Char(','));
+            for (const auto &entry: entryList) {
+                int midPoint = entry.indexOf(QLatin1Char('='));
+                if (midPoint < 0) {
+                    qWarning() << "Malformed entry in" << fileName << ":" << entry;
+                    continue;
+                }
+                env.insert(entry.left(midPoint).toString(), entry.mid(midPoint+1).toString());
+            }
+            return env;
+        }
+    }
+
     Session::Session()
-        : m_valid(false)
-        , m_type(UnknownSession)
-        , m_isHidden(false)
-        , m_isNoDisplay(false)
     {
+        static const QSharedPointer<const Entry> none(new Entry);
+        m_entry = none;
     }
 
     Session::Session(Type type, const QString &fileName)
@@ -44,12 +79,12 @@ namespace SDDM {
 
     bool Session::isValid() const
     {
-        return m_valid;
+        return m_entry->valid;
     }
 
     Session::Type Session::type() const
     {
-        return m_type;
+        return m_entry->type;
     }
 
     int Session::vt() const
@@ -64,61 +99,61 @@ namespace SDDM {
 
     QString Session::xdgSessionType() const
     {
-        return m_xdgSessionType;
+        return m_entry->xdgSessionType;
     }
 
     QDir Session::directory() const
     {
-        return m_dir;
+        return m_entry->dir;
     }
 
     QString Session::fileName() const
     {
-        return m_fileName;
+        return m_entry->fileName;
     }
 
     QString Session::displayName() const
     {
-        return m_displayName;
+        return m_entry->displayName;
     }
 
     QString Session::comment() const
     {
-        return m_comment;
+        return m_entry->comment;
     }
 
     QString Session::exec() const
     {
-        return m_exec;
+        return m_entry->exec;
     }
 
     QString Session::tryExec() const
     {
-        return m_tryExec;
+        return m_entry->tryExec;
     }
 
     QString Session::desktopSession() const
     {
-        return QFileInfo(m_fileName).completeBaseName();
+        return QFileInfo(m_entry->fileName).completeBaseName();
     }
 
     QString Session::desktopNames() const
     {
-        return m_desktopNames;
+        return m_entry->desktopNames;
     }
 
     bool Session::isHidden() const
     {
-        return m_isHidden;
+        return m_entry->isHidden;
     }
 
     bool Session::isNoDisplay() const
     {
-        return m_isNoDisplay;
+        return m_entry->isNoDisplay;
     }
 
     QProcessEnvironment Session::additionalEnv() const {
-        return m_additionalEnv;
+        return m_entry->additionalEnv;
     }
 
     void Session::setTo(Type type, const QString &_fileName)
@@ -127,33 +162,53 @@ namespace SDDM {
         if (!fileName.endsWith(s_entryExtention))
             fileName += s_entryExtention;
 
-        QFileInfo info(fileName);
+        m_entry = entry(type, fileName);
+    }
+
+    QSharedPointer<const Session::Entry> Session::entry(Type type, const QString &fileName)
+    {
+        struct CachedEntry {
+            QSharedPointer<const Entry> entry;
+            QDateTime modified;
+            qint64 size;
+        };
+        static QMutex cacheMutex;
+        static QHash<QString, CachedEntry> cache;
 
-        m_type = UnknownSession;
-        m_valid = false;
-        m_desktopNames.clear();
+        QSharedPointer<Entry> entry(new Entry);
 
         switch (type) {
         case WaylandSession:
-            m_dir = QDir(mainConfig.Wayland.SessionDir.get());
-            m_xdgSessionType = QStringLiteral("wayland");
+            entry->dir = QDir(mainConfig.Wayland.SessionDir.get());
+            entry->xdgSessionType = QStringLiteral("wayland");
             break;
         case X11Session:
-            m_dir = QDir(mainConfig.X11.SessionDir.get());
-            m_xdgSessionType = QStringLiteral("x11");
+            entry->dir = QDir(mainConfig.X11.SessionDir.get());
+            entry->xdgSessionType = QStringLiteral("x11");
             break;
         default:
-            m_xdgSessionType.clear();
             break;
         }
 
-        m_fileName = m_dir.absoluteFilePath(fileName);
+        entry->fileName = entry->dir.absoluteFilePath(fileName);
+
+        // the same file is read as another type of session too
+        const QString key = QString::number(type) + QLatin1Char(':') + entry->fileName;
+        const QFileInfo info(entry->fileName);
+        const QDateTime modified = info.lastModified();
+        const qint64 size = info.size();
 
-        qDebug() << "Reading from" << m_fileName;
+        QMutexLocker locker(&cacheMutex);
+        auto it = cache.constFind(key);
+        if (it != cache.constEnd() && it->modified == modified && it->size == size)
+            return it->entry;
+        locker.unlock();
 
-        QFile file(m_fileName);
+        qDebug() << "Reading from" << entry->fileName;
+
+        QFile file(entry->fileName);
         if (!file.open(QIODevice::ReadOnly))
-            return;
+            return entry;
 
         QString current_section;
 
@@ -172,50 +227,30 @@ namespace SDDM {
                 continue; // We are only interested in the "Desktop Entry" section
 
             if (line.startsWith(QLatin1String("Name=")))
-                m_displayName = line.mid(5);
+                entry->displayName = line.mid(5);
             if (line.startsWith(QLatin1String("Comment=")))
-                m_comment = line.mid(8);
+                entry->comment = line.mid(8);
             if (line.startsWith(QLatin1String("Exec=")))
-                m_exec = line.mid(5);
+                entry->exec = line.mid(5);
             if (line.startsWith(QStringLiteral("TryExec=")))
-                m_tryExec = line.mid(8);
+                entry->tryExec = line.mid(8);
             if (line.startsWith(QLatin1String("DesktopNames=")))
-                m_desktopNames = line.mid(13).replace(QLatin1Char(';'), QLatin1Char(':'));
+                entry->desktopNames = line.mid(13).replace(QLatin1Char(';'), QLatin1Char(':'));
             if (line.startsWith(QLatin1String("Hidden=")))
-                m_isHidden = line.mid(7).toLower() == QLatin1String("true");
+                entry->isHidden = line.mid(7).toLower() == QLatin1String("true");
             if (line.startsWith(QLatin1String("NoDisplay=")))
-                m_isNoDisplay = line.mid(10).toLower() == QLatin1String("true");
+                entry->isNoDisplay = line.mid(10).toLower() == QLatin1String("true");
             if (line.startsWith(QLatin1String("X-SDDM-Env=")))
-                m_additionalEnv = parseEnv(line.mid(strlen("X-SDDM-Env=")));
+                entry->additionalEnv = parseEnv(entry->fileName, line.mid(strlen("X-SDDM-Env=")));
         }
 
         file.close();
 
-        m_type = type;
-        m_valid = true;
-    }
+        entry->type = type;
+        entry->valid = true;
 
-    Session &Session::operator=(const Session &other)
-    {
-        setTo(other.type(), other.fileName());
-        return *this;
+        locker.relock();
+        cache.insert(key, CachedEntry { entry, modified, size });
+        return entry;
     }
-
-    QProcessEnvironment SDDM::Session::parseEnv(const QString &list)
-    {
-        QProcessEnvironment env;
-
-        const QVector<QStringRef> entryList = list.splitRef(QLatin1Char(','));
-        for (const auto &entry: entryList) {
-            int midPoint = entry.indexOf(QLatin1Char('='));
-            if (midPoint < 0) {
-                qWarning() << "Malformed entry in" << fileName() << ":" << entry;
-                continue;
-            }
-            env.insert(entry.left(midPoint).toString(), entry.mid(midPoint+1).toString());
-        }
-        return env;
-    }
-
-
 }
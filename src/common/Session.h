@@ -28,6 +28,14 @@
 namespace SDDM {
     class SessionModel;
 
+    /**
+     * A session .desktop file.
+     *
+     * The parsed contents are kept in a process wide cache keyed by the
+     * path and validated against the file's modification time and size,
+     * so setting a session to a file read before, copying or receiving
+     * one only costs a stat() as long as the file hasn't changed.
+     */
     class Session {
     public:
         enum Type {
@@ -67,25 +75,13 @@ namespace SDDM {
 
         void setTo(Type type, const QString &name);
 
-        Session &operator=(const Session &other);
-
     private:
-        QProcessEnvironment parseEnv(const QString &list);
-        bool m_valid;
-        Type m_type;
+        struct Entry;
+        static QSharedPointer<const Entry> entry(Type type, const QString &fileName);
+
+        // parsed once per file and shared by all copies
+        QSharedPointer<const Entry> m_entry;
         int m_vt = 0;
-        QDir m_dir;
-        QString m_name;
-        QString m_fileName;
-        QString m_displayName;
-        QString m_comment;
-        QString m_exec;
-        QString m_tryExec;
-        QString m_xdgSessionType;
-        QString m_desktopNames;
-        QProcessEnvironment m_additionalEnv;
-        bool m_isHidden;
-        bool m_isNoDisplay;
 
         friend class SessionModel;
     };
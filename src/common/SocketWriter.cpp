@@ -20,32 +20,48 @@
 
 #include "SocketWriter.h"
 
+#include "FramedChannel.h"
+
 namespace SDDM {
-    SocketWriter::SocketWriter(QLocalSocket *socket) : socket(socket) {
-        output = new QDataStream(&data, QIODevice::WriteOnly);
+    SocketWriter::SocketWriter(FramedChannel *channel) : output(&data, QIODevice::WriteOnly), channel(channel) {
     }
 
     SocketWriter::~SocketWriter() {
-        socket->write(data);
-        socket->flush();
-
-        delete output;
+        channel->send(data);
     }
 
     SocketWriter &SocketWriter::operator << (const quint32 &u) {
-        *output << u;
+        output << u;
+
+        return *this;
+    }
+
+    SocketWriter &SocketWriter::operator << (bool b) {
+        output << b;
 
         return *this;
     }
 
     SocketWriter &SocketWriter::operator << (const QString &s) {
-        *output << s;
+        output << s;
+
+        return *this;
+    }
+
+    SocketWriter &SocketWriter::operator << (const QStringList &l) {
+        output << l;
 
         return *this;
     }
 
     SocketWriter &SocketWriter::operator << (const Session &s) {
-        *output << s;
+        output << s;
+
+        return *this;
+    }
+
+    SocketWriter &SocketWriter::operator << (const UserEntryList &l) {
+        output << l;
 
         return *this;
     }
@@ -22,25 +22,34 @@
 #define SDDM_SOCKETWRITER_H
 
 #include <QDataStream>
-#include <QLocalSocket>
 
 #include "Session.h"
+#include "UserEntry.h"
 
 namespace SDDM {
+    class FramedChannel;
+
+    /**
+     * Serializes one message and queues it on the channel as a single
+     * frame once the writer goes out of scope.
+     */
     class SocketWriter {
         Q_DISABLE_COPY(SocketWriter)
     public:
-        SocketWriter(QLocalSocket *socket);
+        SocketWriter(FramedChannel *channel);
         ~SocketWriter();
 
         SocketWriter &operator << (const quint32 &u);
+        SocketWriter &operator << (bool b);
         SocketWriter &operator << (const QString &s);
+        SocketWriter &operator << (const QStringList &l);
         SocketWriter &operator << (const Session &s);
+        SocketWriter &operator << (const UserEntryList &l);
 
     private:
         QByteArray data;
-        QDataStream *output;
-        QLocalSocket *socket;
+        QDataStream output;
+        FramedChannel *channel;
     };
 }
 
@@ -0,0 +1,106 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERENTRY_H
+#define SDDM_USERENTRY_H
+
+#include <QDataStream>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+#include <algorithm>
+
+#include <pwd.h>
+#include <string.h>
+
+namespace SDDM {
+    /**
+     * What the greeter needs to know about an account, as sent to it by
+     * the daemon's user directory.
+     */
+    struct UserEntry {
+        UserEntry() {
+        }
+
+        explicit UserEntry(const struct passwd *data) :
+            name(QString::fromLocal8Bit(data->pw_name)),
+            realName(QString::fromLocal8Bit(data->pw_gecos).section(QLatin1Char(','), 0, 0)),
+            homeDir(QString::fromLocal8Bit(data->pw_dir)),
+            uid(data->pw_uid),
+            gid(data->pw_gid),
+            // if shadow is used pw_passwd will be 'x' nevertheless, so this
+            // will always be true
+            needsPassword(strcmp(data->pw_passwd, "") != 0) {
+        }
+
+        bool operator==(const UserEntry &other) const {
+            return name == other.name && realName == other.realName && homeDir == other.homeDir &&
+                   uid == other.uid && gid == other.gid && needsPassword == other.needsPassword && icon == other.icon;
+        }
+
+        bool operator!=(const UserEntry &other) const {
+            return !(*this == other);
+        }
+
+        QString name;
+        QString realName;
+        QString homeDir;
+        quint32 uid { 0 };
+        quint32 gid { 0 };
+        bool needsPassword { false };
+        // avatar found without looking into the home directory, if any
+        QString icon;
+    };
+
+    typedef QVector<UserEntry> UserEntryList;
+
+    /**
+     * Cuts a list sorted by name down to its first limit users, keeping
+     * lastUser. Returns false if users had to be dropped.
+     */
+    inline bool limitUsers(UserEntryList &users, int limit, const QString &lastUser) {
+        if (limit <= 0 || users.size() <= limit)
+            return true;
+
+        // the last user sorts after all the others left
+        auto it = std::lower_bound(users.cbegin(), users.cend(), lastUser, [](const UserEntry &user, const QString &name) { return user.name < name; });
+        const bool keepLastUser = it != users.cend() && it->name == lastUser && it - users.cbegin() >= limit;
+        const UserEntry last = keepLastUser ? *it : UserEntry();
+
+        users.resize(limit);
+        if (keepLastUser)
+            users << last;
+        return false;
+    }
+
+    inline QDataStream &operator<<(QDataStream &stream, const UserEntry &user) {
+        stream << user.name << user.realName << user.homeDir << user.uid << user.gid << user.needsPassword << user.icon;
+        return stream;
+    }
+
+    inline QDataStream &operator>>(QDataStream &stream, UserEntry &user) {
+        stream >> user.name >> user.realName >> user.homeDir >> user.uid >> user.gid >> user.needsPassword >> user.icon;
+        return stream;
+    }
+}
+
+Q_DECLARE_METATYPE(SDDM::UserEntryList)
+
+#endif // SDDM_USERENTRY_H
@@ -0,0 +1,148 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserIndex.h"
+
+#include "Constants.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+#define USER_INDEX_MAGIC 0x58495553 // "SUIX"
+#define USER_INDEX_VERSION 1
+
+namespace SDDM {
+    namespace {
+        struct Header {
+            quint32 magic;
+            quint32 version;
+            quint32 count;
+            // length of the text, in UTF-16 code units
+            quint32 textSize;
+        };
+
+        struct Text {
+            quint32 offset;
+            quint32 size;
+        };
+
+        struct Record {
+            quint32 uid;
+            quint32 gid;
+            quint32 flags;
+            Text name;
+            Text realName;
+            Text homeDir;
+            Text icon;
+        };
+
+        enum RecordFlag {
+            NeedsPassword = 0x1
+        };
+
+        Text append(QString &text, const QString &s) {
+            Text t { quint32(text.size()), quint32(s.size()) };
+            text.append(s);
+            return t;
+        }
+    }
+
+    QString UserIndex::defaultPath() {
+        // next to the state config, in the home of the greeter user
+        struct passwd *pw = getpwnam("sddm");
+        const QString stateDir = pw ? QString::fromLocal8Bit(pw->pw_dir) : QStringLiteral(STATE_DIR);
+        return stateDir + QStringLiteral("/users.index");
+    }
+
+    bool UserIndex::read(const QString &path, UserEntryList &users) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(Header)))
+            return false;
+
+        const uchar *data = file.map(0, file.size());
+        if (!data)
+            return false;
+
+        const Header *header = reinterpret_cast<const Header *>(data);
+        const qint64 size = qint64(sizeof(Header)) + qint64(header->count) * qint64(sizeof(Record)) + qint64(header->textSize) * 2;
+        if (header->magic != USER_INDEX_MAGIC || header->version != USER_INDEX_VERSION || size != file.size()) {
+            qWarning() << "Ignoring outdated or damaged user index" << path;
+            return false;
+        }
+
+        const Record *records = reinterpret_cast<const Record *>(data + sizeof(Header));
+        const QChar *text = reinterpret_cast<const QChar *>(records + header->count);
+        auto string = [&](const Text &t, QString &s) {
+            if (quint64(t.offset) + t.size > header->textSize)
+                return false;
+            s = QString(text + t.offset, int(t.size));
+            return true;
+        };
+
+        UserEntryList entries;
+        entries.resize(int(header->count));
+        for (quint32 i = 0; i < header->count; ++i) {
+            const Record &record = records[i];
+            UserEntry &entry = entries[int(i)];
+            if (!string(record.name, entry.name) || !string(record.realName, entry.realName) ||
+                    !string(record.homeDir, entry.homeDir) || !string(record.icon, entry.icon)) {
+                qWarning() << "Ignoring damaged user index" << path;
+                return false;
+            }
+            entry.uid = record.uid;
+            entry.gid = record.gid;
+            entry.needsPassword = record.flags & NeedsPassword;
+        }
+
+        users = entries;
+        return true;
+    }
+
+    bool UserIndex::write(const QString &path, const UserEntryList &users) {
+        QVector<Record> records;
+        records.reserve(users.size());
+        QString text;
+        for (const UserEntry &user : users) {
+            Record record;
+            record.uid = user.uid;
+            record.gid = user.gid;
+            record.flags = user.needsPassword ? NeedsPassword : 0;
+            record.name = append(text, user.name);
+            record.realName = append(text, user.realName);
+            record.homeDir = append(text, user.homeDir);
+            record.icon = append(text, user.icon);
+            records << record;
+        }
+
+        const Header header { USER_INDEX_MAGIC, USER_INDEX_VERSION, quint32(records.size()), quint32(text.size()) };
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write the user index" << path << file.errorString();
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(records.constData()), records.size() * int(sizeof(Record)));
+        file.write(reinterpret_cast<const char *>(text.constData()), text.size() * 2);
+        // the greeter reads it
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther);
+        return file.commit();
+    }
+}
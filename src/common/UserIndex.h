@@ -0,0 +1,48 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERINDEX_H
+#define SDDM_USERINDEX_H
+
+#include "UserEntry.h"
+
+namespace SDDM {
+    /**
+     * The user list as last found by the daemon, kept in the state
+     * directory so that the greeter can show it before the daemon has
+     * enumerated the users again.
+     *
+     * The file is a header, one fixed size record per user and the
+     * UTF-16 text the records point into, in native byte order. It is
+     * memory mapped for reading; a file of another version or one that
+     * doesn't add up is ignored.
+     */
+    class UserIndex {
+    public:
+        static QString defaultPath();
+
+        static bool read(const QString &path, UserEntryList &users);
+        static bool write(const QString &path, const UserEntryList &users);
+
+    private:
+        UserIndex() = delete;
+    };
+}
+
+#endif // SDDM_USERINDEX_H
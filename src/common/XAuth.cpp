@@ -18,18 +18,85 @@
 * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 ***************************************************************************/
 
+#include <QDataStream>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QSaveFile>
 #include <QUuid>
 
-#include "Configuration.h"
 #include "Constants.h"
 #include "XAuth.h"
 
-#include <random>
+#include <errno.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+#include <sys/random.h>
+#endif
 
 namespace SDDM {
 
+// Xauthority entries, as read and written by libXau
+static const quint16 FamilyLocal = 256;
+static const char MitMagicCookie[] = "MIT-MAGIC-COOKIE-1";
+
+static bool randomBytes(char *buffer, size_t size)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    size_t done = 0;
+    while (done < size) {
+        ssize_t count = ::getrandom(buffer + done, size - done, 0);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        done += size_t(count);
+    }
+    if (done == size)
+        return true;
+#endif
+
+    // kernels without getrandom()
+    QFile urandom(QStringLiteral("/dev/urandom"));
+    return urandom.open(QIODevice::ReadOnly) && urandom.read(buffer, qint64(size)) == qint64(size);
+}
+
+static QByteArray localHostName()
+{
+    char name[256] = { 0 };
+    if (::gethostname(name, sizeof(name) - 1) != 0)
+        return QByteArray();
+    return QByteArray(name);
+}
+
+// ":0.1" -> "0"
+static QByteArray displayNumber(const QString &display)
+{
+    QString number = display.mid(display.lastIndexOf(QLatin1Char(':')) + 1);
+    const int dot = number.indexOf(QLatin1Char('.'));
+    if (dot >= 0)
+        number.truncate(dot);
+    return number.toLatin1();
+}
+
+static bool readCounted(QDataStream &stream, QByteArray &data)
+{
+    quint16 size;
+    stream >> size;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    data.resize(size);
+    return stream.readRawData(data.data(), size) == size;
+}
+
+static void writeCounted(QDataStream &stream, const QByteArray &data)
+{
+    stream << quint16(data.size());
+    stream.writeRawData(data.constData(), data.size());
+}
+
 XAuth::XAuth()
 {
     m_authDir = QStringLiteral(RUNTIME_DIR);
@@ -75,17 +142,7 @@ void XAuth::setup()
     qDebug() << "Xauthority path:" << m_authPath;
 
     // Generate cookie
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 15);
-
-    // Reseve 32 bytes
-    m_cookie.reserve(32);
-
-    // Create a random hexadecimal number
-    const char *digits = "0123456789abcdef";
-    for (int i = 0; i < 32; ++i)
-        m_cookie[i] = QLatin1Char(digits[dis(gen)]);
+    m_cookie = generateCookie();
 }
 
 bool XAuth::addCookie(const QString &display)
@@ -98,30 +155,108 @@ bool XAuth::addCookie(const QString &display)
     return XAuth::addCookieToFile(display, m_authPath, m_cookie);
 }
 
+QString XAuth::generateCookie()
+{
+    // 128 bits, as hexadecimal number
+    char bytes[16];
+    if (!randomBytes(bytes, sizeof(bytes))) {
+        qCritical("Failed to get random data for the X authorization cookie");
+        return QString();
+    }
+
+    return QString::fromLatin1(QByteArray(bytes, sizeof(bytes)).toHex());
+}
+
+QVector<XAuth::Entry> XAuth::readEntries(const QByteArray &data)
+{
+    QVector<Entry> entries;
+
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::BigEndian);
+    while (!stream.atEnd()) {
+        Entry entry;
+        stream >> entry.family;
+        if (stream.status() != QDataStream::Ok ||
+                !readCounted(stream, entry.address) ||
+                !readCounted(stream, entry.number) ||
+                !readCounted(stream, entry.name) ||
+                !readCounted(stream, entry.data)) {
+            qWarning() << "Ignoring the truncated end of an Xauthority file";
+            break;
+        }
+        entries << entry;
+    }
+
+    return entries;
+}
+
+QByteArray XAuth::writeEntries(const QVector<Entry> &entries)
+{
+    QByteArray data;
+
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::BigEndian);
+    for (const Entry &entry : entries) {
+        stream << entry.family;
+        writeCounted(stream, entry.address);
+        writeCounted(stream, entry.number);
+        writeCounted(stream, entry.name);
+        writeCounted(stream, entry.data);
+    }
+
+    return data;
+}
+
 bool XAuth::addCookieToFile(const QString &display, const QString &fileName,
                             const QString &cookie)
 {
     qDebug() << "Adding cookie to" << fileName;
 
-    // Touch file
-    QFile file_handler(fileName);
-    file_handler.open(QIODevice::Append);
-    file_handler.close();
+    const QByteArray data = QByteArray::fromHex(cookie.toLatin1());
+    if (data.isEmpty()) {
+        qWarning() << "Invalid X authorization cookie";
+        return false;
+    }
 
-    QString cmd = QStringLiteral("%1 -f %2 -q").arg(mainConfig.X11.XauthPath.get()).arg(fileName);
+    // What "xauth add <display> . <cookie>" would write for a local display
+    Entry added;
+    added.family = FamilyLocal;
+    added.address = localHostName();
+    added.number = displayNumber(display);
+    added.name = QByteArray(MitMagicCookie);
+    added.data = data;
 
-    // Execute xauth
-    FILE *fp = ::popen(qPrintable(cmd), "w");
+    // Keep the entries for other displays, replace those for this one
+    QVector<Entry> entries;
+    QFile existing(fileName);
+    if (existing.open(QIODevice::ReadOnly)) {
+        const QVector<Entry> old = readEntries(existing.readAll());
+        for (const Entry &entry : old) {
+            if (entry.family != added.family || entry.address != added.address || entry.number != added.number)
+                entries << entry;
+        }
+        existing.close();
+    }
+    entries << added;
 
-    // Check file
-    if (!fp)
+    // Write to a temporary file and rename it over the old one, so that
+    // the X server or a client never sees a partial file
+    QSaveFile file(fileName);
+    file.setDirectWriteFallback(true);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open" << fileName << ":" << file.errorString();
         return false;
-    fprintf(fp, "remove %s\n", qPrintable(display));
-    fprintf(fp, "add %s . %s\n", qPrintable(display), qPrintable(cookie));
-    fprintf(fp, "exit\n");
+    }
+    if (!existing.exists())
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+    file.write(writeEntries(entries));
+
+    if (!file.commit()) {
+        qWarning() << "Failed to write" << fileName << ":" << file.errorString();
+        return false;
+    }
 
-    // Close pipe
-    return pclose(fp) == 0;
+    return true;
 }
 
 } // namespace SDDM
@@ -21,7 +21,9 @@
 #ifndef SDDM_XAUTH_H
 #define SDDM_XAUTH_H
 
+#include <QByteArray>
 #include <QString>
+#include <QVector>
 
 namespace SDDM {
 
@@ -43,6 +45,20 @@ public:
                                 const QString &fileName,
                                 const QString &cookie);
 
+    static QString generateCookie();
+
+    // One record of an Xauthority file
+    struct Entry {
+        quint16 family;
+        QByteArray address;
+        QByteArray number;
+        QByteArray name;
+        QByteArray data;
+    };
+
+    static QVector<Entry> readEntries(const QByteArray &data);
+    static QByteArray writeEntries(const QVector<Entry> &entries);
+
 private:
     bool m_setup = false;
     QString m_authDir;
@@ -20,11 +20,14 @@
 #include "DaemonApp.h"
 
 #include "Configuration.h"
+#include "ConfigWatcher.h"
 #include "Constants.h"
 #include "DisplayManager.h"
+#include "LogindSessions.h"
 #include "PowerManager.h"
 #include "SeatManager.h"
 #include "SignalHandler.h"
+#include "UserDirectory.h"
 
 #include "MessageHandler.h"
 
@@ -49,12 +52,21 @@ namespace SDDM {
         // set testing parameter
         m_testing = (arguments().indexOf(QStringLiteral("--test-mode")) != -1);
 
+        // keep the configuration up to date
+        m_configWatcher = new ConfigWatcher(&mainConfig, this);
+
         // create display manager
         m_displayManager = new DisplayManager(this);
 
         // create power manager
         m_powerManager = new PowerManager(this);
 
+        // list the users before the first greeter asks for them
+        m_userDirectory = new UserDirectory(this);
+
+        // follow the sessions, for reusing them on login
+        m_logindSessions = new LogindSessions(this);
+
         // create seat manager
         m_seatManager = new SeatManager(this);
 
@@ -91,6 +103,10 @@ namespace SDDM {
         return m_displayManager;
     }
 
+    LogindSessions *DaemonApp::logindSessions() const {
+        return m_logindSessions;
+    }
+
     PowerManager *DaemonApp::powerManager() const {
         return m_powerManager;
     }
@@ -103,6 +119,10 @@ namespace SDDM {
         return m_signalHandler;
     }
 
+    UserDirectory *DaemonApp::userDirectory() const {
+        return m_userDirectory;
+    }
+
     int DaemonApp::newSessionId() {
         return m_lastSessionId++;
     }
@@ -125,8 +145,7 @@ int main(int argc, char **argv) {
 
     // spit a complete config file on stdout and quit on demand
     if (arguments.contains(QStringLiteral("--example-config"))) {
-        SDDM::mainConfig.wipe();
-        QTextStream(stdout) << SDDM::mainConfig.toConfigFull();
+        QTextStream(stdout) << SDDM::MainConfig::schema().toConfigFull();
         return EXIT_SUCCESS;
     }
 
@@ -26,10 +26,13 @@
 
 namespace SDDM {
     class Configuration;
+    class ConfigWatcher;
     class DisplayManager;
+    class LogindSessions;
     class PowerManager;
     class SeatManager;
     class SignalHandler;
+    class UserDirectory;
 
     class DaemonApp : public QCoreApplication {
         Q_OBJECT
@@ -45,9 +48,11 @@ namespace SDDM {
 
         QString hostName() const;
         DisplayManager *displayManager() const;
+        LogindSessions *logindSessions() const;
         PowerManager *powerManager() const;
         SeatManager *seatManager() const;
         SignalHandler *signalHandler() const;
+        UserDirectory *userDirectory() const;
 
     public slots:
         int newSessionId();
@@ -58,10 +63,13 @@ namespace SDDM {
         int m_lastSessionId { 0 };
 
         bool m_testing { false };
+        ConfigWatcher *m_configWatcher { nullptr };
         DisplayManager *m_displayManager { nullptr };
+        LogindSessions *m_logindSessions { nullptr };
         PowerManager *m_powerManager { nullptr };
         SeatManager *m_seatManager { nullptr };
         SignalHandler *m_signalHandler { nullptr };
+        UserDirectory *m_userDirectory { nullptr };
     };
 }
 
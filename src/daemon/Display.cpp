@@ -26,6 +26,8 @@
 #include "DisplayManager.h"
 #include "XorgDisplayServer.h"
 #include "XorgUserDisplayServer.h"
+#include "EnvironmentTemplate.h"
+#include "LogindSessions.h"
 #include "Seat.h"
 #include "SocketServer.h"
 #include "Greeter.h"
@@ -46,7 +48,6 @@
 #include <QDBusReply>
 
 #include "Login1Manager.h"
-#include "Login1Session.h"
 #include "VirtualTerminal.h"
 #include "WaylandDisplayServer.h"
 
@@ -99,6 +100,7 @@ namespace SDDM {
 
         // respond to authentication requests
         m_auth->setVerbose(true);
+        m_auth->setZygote(m_seat->helperZygote());
         connect(m_auth, &Auth::requestChanged, this, &Display::slotRequestChanged);
         connect(m_auth, &Auth::authentication, this, &Display::slotAuthenticationFinished);
         connect(m_auth, &Auth::sessionStarted, this, &Display::slotSessionStarted);
@@ -106,9 +108,14 @@ namespace SDDM {
         connect(m_auth, &Auth::info, this, &Display::slotAuthInfo);
         connect(m_auth, &Auth::error, this, &Display::slotAuthError);
 
+        // load the next greeter while the session runs
+        connect(m_greeter, &Greeter::stopped, this, &Display::slotGreeterStopped);
+
         // restart display after display server ended
         connect(m_displayServer, &DisplayServer::started, this, &Display::displayServerStarted);
+        connect(m_displayServer, &DisplayServer::ready, this, &Display::displayServerReady);
         connect(m_displayServer, &DisplayServer::stopped, this, &Display::stop);
+        connect(m_displayServer, &DisplayServer::failed, this, &Display::startFailed);
 
         // connect login signal
         connect(m_socketServer, &SocketServer::login, this, &Display::login);
@@ -188,12 +195,18 @@ namespace SDDM {
         if (m_started)
             return;
 
-        // setup display
-        m_displayServer->setupDisplay();
-
         // log message
         qDebug() << "Display server started.";
 
+        // setup display, continues in displayServerReady()
+        m_displayServer->setupDisplay();
+    }
+
+    void Display::displayServerReady() {
+        // check flag
+        if (m_started)
+            return;
+
         if ((daemonApp->first || mainConfig.Autologin.Relogin.get()) &&
             !mainConfig.Autologin.User.get().isEmpty()) {
             // reset first flag
@@ -244,8 +257,10 @@ namespace SDDM {
         if (!m_started)
             return;
 
-        // stop the greeter
+        // stop the greeter, which isn't to be replaced by a standby one
+        m_stopping = true;
         m_greeter->stop();
+        m_stopping = false;
 
         // stop socket server
         m_socketServer->stop();
@@ -255,8 +270,9 @@ namespace SDDM {
         m_displayServer->stop();
         m_displayServer->blockSignals(false);
 
-        // reset flag
+        // reset flags
         m_started = false;
+        m_standby = false;
 
         // emit signal
         emit stopped();
@@ -338,18 +354,11 @@ namespace SDDM {
         m_reuseSessionId = QString();
 
         if (Logind::isAvailable() && mainConfig.Users.ReuseSession.get()) {
-            OrgFreedesktopLogin1ManagerInterface manager(Logind::serviceName(), Logind::managerPath(), QDBusConnection::systemBus());
-            auto reply = manager.ListSessions();
-            reply.waitForFinished();
-
-            const auto info = reply.value();
-            for(const SessionInfo &s : reply.value()) {
-                if (s.userName == user) {
-                    OrgFreedesktopLogin1SessionInterface session(Logind::serviceName(), s.sessionPath.path(), QDBusConnection::systemBus());
-                    if (session.service() == QLatin1String("sddm") && session.state() == QLatin1String("online")) {
-                        m_reuseSessionId = s.sessionId;
-                        break;
-                    }
+            const auto sessions = daemonApp->logindSessions()->sessions(user);
+            for (const LogindSessions::Session &s : sessions) {
+                if (s.service == QLatin1String("sddm") && s.state == QLatin1String("online")) {
+                    m_reuseSessionId = s.id;
+                    break;
                 }
             }
         }
@@ -367,17 +376,19 @@ namespace SDDM {
         // some information
         qDebug() << "Session" << m_sessionName << "selected, command:" << session.exec();
 
-        QProcessEnvironment env;
-        env.insert(session.additionalEnv());
+        // what every session on the seat gets, the session file can't override it
+        QProcessEnvironment env = seat()->environment()->session();
+        const QProcessEnvironment additionalEnv = session.additionalEnv();
+        for (const QString &key : additionalEnv.keys()) {
+            if (!env.contains(key))
+                env.insert(key, additionalEnv.value(key));
+        }
 
-        env.insert(QStringLiteral("PATH"), mainConfig.Users.DefaultPath.get());
-        env.insert(QStringLiteral("XDG_SEAT_PATH"), daemonApp->displayManager()->seatPath(seat()->name()));
         env.insert(QStringLiteral("XDG_SESSION_PATH"), daemonApp->displayManager()->sessionPath(QStringLiteral("Session%1").arg(daemonApp->newSessionId())));
         env.insert(QStringLiteral("DESKTOP_SESSION"), session.desktopSession());
         env.insert(QStringLiteral("XDG_CURRENT_DESKTOP"), session.desktopNames());
         env.insert(QStringLiteral("XDG_SESSION_CLASS"), QStringLiteral("user"));
         env.insert(QStringLiteral("XDG_SESSION_TYPE"), session.xdgSessionType());
-        env.insert(QStringLiteral("XDG_SEAT"), seat()->name());
         env.insert(QStringLiteral("XDG_VTNR"), QString::number(m_lastSession.vt()));
         env.insert(QStringLiteral("XDG_SESSION_DESKTOP"), session.desktopNames());
 
@@ -408,7 +419,7 @@ namespace SDDM {
                     m_auth->setCookie(qobject_cast<XorgDisplayServer *>(m_displayServer)->cookie());
             }
 
-            // save last user and last session
+            // save last user and last session, written out in the background
             if (mainConfig.Users.RememberLastUser.get())
                 stateConfig.Last.User.set(m_auth->user());
             else
@@ -456,14 +467,54 @@ namespace SDDM {
         // we want to avoid greeter from restarting when an authentication
         // error happens (in this case we want to show the message from the
         // greeter
-        if (status != Auth::HELPER_AUTH_ERROR)
+        if (status != Auth::HELPER_AUTH_ERROR) {
+            // the greeter is already waiting on our display server
+            if (m_standby) {
+                qDebug() << "Switching to the standby greeter on vt" << m_terminalId;
+                m_standby = false;
+                m_greeter->setStandby(false);
+                VirtualTerminal::jumpToVt(m_terminalId, true);
+                return;
+            }
+
             stop();
+        }
 
         // Start the greeter again as soon as the user session is closed
         if (m_auth->user() != QLatin1String("sddm"))
             m_greeter->start();
     }
 
+    void Display::slotGreeterStopped() {
+        // we stopped it ourselves
+        if (m_stopping)
+            return;
+
+        // the standby greeter went away by itself, start over on logout
+        if (m_standby) {
+            qWarning() << "Standby greeter exited";
+            m_standby = false;
+            m_greeter->setStandby(false);
+            return;
+        }
+
+        // the greeter leaves once the user is logged in, load the next one
+        // on the display server we have while the session runs on its own VT
+        // (a reused session is switched to instead, the helper just unlocks it)
+        if (!mainConfig.StandbyGreeter.get() || !m_started || !m_auth->isActive() ||
+            !m_reuseSessionId.isNull() || m_displayServerType != X11DisplayServerType ||
+            m_seat->name() != QLatin1String("seat0"))
+            return;
+
+        qDebug() << "Starting standby greeter on vt" << m_terminalId;
+        m_standby = true;
+        m_greeter->setStandby(true);
+        if (!m_greeter->start()) {
+            m_standby = false;
+            m_greeter->setStandby(false);
+        }
+    }
+
     void Display::slotRequestChanged() {
         if (m_auth->request()->prompts().length() == 1) {
             m_auth->request()->prompts()[0]->setResponse(qPrintable(m_passPhrase));
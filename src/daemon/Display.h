@@ -72,9 +72,12 @@ namespace SDDM {
                    const Session &session);
         bool attemptAutologin();
         void displayServerStarted();
+        void displayServerReady();
 
     signals:
         void stopped();
+        // the display server gave up while starting
+        void startFailed();
 
         void loginFailed(QLocalSocket *socket);
         void loginSucceeded(QLocalSocket *socket);
@@ -90,6 +93,8 @@ namespace SDDM {
 
         bool m_relogin { true };
         bool m_started { false };
+        bool m_standby { false };
+        bool m_stopping { false };
 
         int m_terminalId { 7 };
 
@@ -131,6 +136,7 @@ namespace SDDM {
         void slotHelperFinished(Auth::HelperExitStatus status);
         void slotAuthInfo(const QString &message, Auth::Info info);
         void slotAuthError(const QString &message, Auth::Error error);
+        void slotGreeterStopped();
     };
 }
 
@@ -27,6 +27,7 @@ class QProcess;
 
 namespace SDDM {
     class Display;
+    class HookRunner;
 
     class DisplayServer : public QObject {
         Q_OBJECT
@@ -40,6 +41,10 @@ namespace SDDM {
 
         virtual QString sessionType() const = 0;
 
+        // cleanup still running after the server has stopped, it may
+        // outlive this object
+        virtual HookRunner *stopHooks() const;
+
     public slots:
         virtual bool start() = 0;
         virtual void stop() = 0;
@@ -48,6 +53,10 @@ namespace SDDM {
 
     signals:
         void started();
+        // a start that was underway didn't work out
+        void failed();
+        // the setup the greeter depends on is done
+        void ready();
         void stopped();
 
     protected:
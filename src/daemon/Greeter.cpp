@@ -23,6 +23,7 @@
 #include "Constants.h"
 #include "DaemonApp.h"
 #include "DisplayManager.h"
+#include "EnvironmentTemplate.h"
 #include "Seat.h"
 #include "ThemeConfig.h"
 #include "ThemeMetadata.h"
@@ -73,6 +74,10 @@ namespace SDDM {
         }
     }
 
+    void Greeter::setStandby(bool standby) {
+        m_standby = standby;
+    }
+
     QString Greeter::displayServerCommand() const
     {
         return m_displayServerCmd;
@@ -171,29 +176,17 @@ namespace SDDM {
             cmd << QStringLiteral("%1/sddm-greeter").arg(QStringLiteral(BIN_INSTALL_DIR))
                 << args;
 
-            // greeter environment
-            QProcessEnvironment env;
-            QProcessEnvironment sysenv = QProcessEnvironment::systemEnvironment();
-
-            insertEnvironmentList({QStringLiteral("LANG"), QStringLiteral("LANGUAGE"),
-                                   QStringLiteral("LC_CTYPE"), QStringLiteral("LC_NUMERIC"), QStringLiteral("LC_TIME"), QStringLiteral("LC_COLLATE"),
-                                   QStringLiteral("LC_MONETARY"), QStringLiteral("LC_MESSAGES"), QStringLiteral("LC_PAPER"), QStringLiteral("LC_NAME"),
-                                   QStringLiteral("LC_ADDRESS"), QStringLiteral("LC_TELEPHONE"), QStringLiteral("LC_MEASUREMENT"), QStringLiteral("LC_IDENTIFICATION"),
-                                   QStringLiteral("LD_LIBRARY_PATH"),
-                                   QStringLiteral("QML2_IMPORT_PATH"),
-                                   QStringLiteral("QT_PLUGIN_PATH"),
-                                   QStringLiteral("XDG_DATA_DIRS")
-            }, sysenv, env);
-
-            env.insert(QStringLiteral("PATH"), mainConfig.Users.DefaultPath.get());
+            // greeter environment, on top of what every greeter on the seat gets
+            QProcessEnvironment env = m_display->seat()->environment()->greeter();
             env.insert(QStringLiteral("XCURSOR_THEME"), xcursorTheme);
-            env.insert(QStringLiteral("XDG_SEAT"), m_display->seat()->name());
-            env.insert(QStringLiteral("XDG_SEAT_PATH"), daemonApp->displayManager()->seatPath(m_display->seat()->name()));
             env.insert(QStringLiteral("XDG_SESSION_PATH"), daemonApp->displayManager()->sessionPath(QStringLiteral("Session%1").arg(daemonApp->newSessionId())));
             if (m_display->seat()->name() == QLatin1String("seat0"))
                 env.insert(QStringLiteral("XDG_VTNR"), QString::number(m_display->terminalId()));
             env.insert(QStringLiteral("XDG_SESSION_CLASS"), QStringLiteral("greeter"));
             env.insert(QStringLiteral("XDG_SESSION_TYPE"), m_display->sessionType());
+            // loaded in the background, the helper leaves the VT alone
+            if (m_standby)
+                env.insert(QStringLiteral("SDDM_STANDBY"), QStringLiteral("1"));
             if (m_display->displayServerType() == Display::X11DisplayServerType) {
                 env.insert(QStringLiteral("DISPLAY"), m_display->name());
                 env.insert(QStringLiteral("XAUTHORITY"), m_authPath);
@@ -220,12 +213,6 @@ namespace SDDM {
         return true;
     }
 
-    void Greeter::insertEnvironmentList(QStringList names, QProcessEnvironment sourceEnv, QProcessEnvironment &targetEnv) {
-        for (QStringList::const_iterator it = names.constBegin(); it != names.constEnd(); ++it)
-            if (sourceEnv.contains(*it))
-                targetEnv.insert(*it, sourceEnv.value(*it));
-    }
-
     void Greeter::stop() {
         // check flag
         if (!m_started)
@@ -260,6 +247,8 @@ namespace SDDM {
             m_process->deleteLater();
             m_process = nullptr;
         }
+
+        emit stopped();
     }
 
     void Greeter::onRequestChanged() {
@@ -300,6 +289,8 @@ namespace SDDM {
         // clean up
         m_auth->deleteLater();
         m_auth = nullptr;
+
+        emit stopped();
     }
 
     void Greeter::onReadyReadStandardError()
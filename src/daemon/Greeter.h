@@ -42,6 +42,7 @@ namespace SDDM {
         void setAuthPath(const QString &authPath);
         void setSocket(const QString &socket);
         void setTheme(const QString &theme);
+        void setStandby(bool standby);
 
         QString displayServerCommand() const;
         void setDisplayServerCommand(const QString &cmd);
@@ -51,6 +52,9 @@ namespace SDDM {
         void stop();
         void finished();
 
+    signals:
+        void stopped();
+
     private slots:
         void onRequestChanged();
         void onSessionStarted(bool success);
@@ -63,6 +67,7 @@ namespace SDDM {
 
     private:
         bool m_started { false };
+        bool m_standby { false };
 
         Display *m_display { nullptr };
         QString m_authPath;
@@ -74,8 +79,6 @@ namespace SDDM {
 
         Auth *m_auth { nullptr };
         QProcess *m_process { nullptr };
-
-        static void insertEnvironmentList(QStringList names, QProcessEnvironment sourceEnv, QProcessEnvironment &targetEnv);
     };
 }
 
@@ -0,0 +1,178 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "LogindSessions.h"
+
+#include "DaemonApp.h"
+#include "LogindDBusTypes.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+
+namespace SDDM {
+    LogindSessions::LogindSessions(QObject *parent) : QObject(parent) {
+        if (daemonApp->testing() || !Logind::isAvailable()) {
+            m_ready = true;
+            return;
+        }
+
+        QDBusConnection bus = QDBusConnection::systemBus();
+
+        // subscribe first, so that nothing falls between the list and the signals
+        bus.connect(Logind::serviceName(), Logind::managerPath(), Logind::managerIfaceName(), QStringLiteral("SessionNew"),
+                    this, SLOT(sessionAdded(QString,QDBusObjectPath)));
+        bus.connect(Logind::serviceName(), Logind::managerPath(), Logind::managerIfaceName(), QStringLiteral("SessionRemoved"),
+                    this, SLOT(sessionRemoved(QString,QDBusObjectPath)));
+        // one match for the properties of all the objects of the service
+        bus.connect(Logind::serviceName(), QString(), QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("PropertiesChanged"),
+                    this, SLOT(propertiesChanged(QString,QVariantMap,QStringList)));
+
+        auto listSessionsMsg = QDBusMessage::createMethodCall(Logind::serviceName(), Logind::managerPath(), Logind::managerIfaceName(), QStringLiteral("ListSessions"));
+        QDBusPendingReply<SessionInfoList> reply = bus.asyncCall(listSessionsMsg);
+
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [=]() {
+            watcher->deleteLater();
+
+            if (reply.isError())
+                qWarning() << "Failed to list the sessions:" << reply.error().message();
+
+            const SessionInfoList sessions = reply.value();
+            for (const SessionInfo &info : sessions)
+                add(info.sessionId, info.sessionPath.path(), info.userName, info.seatId);
+
+            qDebug() << "Tracking" << m_sessions.size() << "sessions";
+            m_ready = true;
+        });
+    }
+
+    bool LogindSessions::isReady() const {
+        return m_ready;
+    }
+
+    QList<LogindSessions::Session> LogindSessions::sessions(const QString &user) const {
+        QList<Session> result;
+        for (auto it = m_users.constFind(user); it != m_users.constEnd() && it.key() == user; ++it)
+            result << m_sessions.value(it.value());
+        return result;
+    }
+
+    void LogindSessions::sessionAdded(const QString &id, const QDBusObjectPath &path) {
+        add(id, path.path(), QString(), QString());
+    }
+
+    void LogindSessions::sessionRemoved(const QString &id, const QDBusObjectPath &path) {
+        Q_UNUSED(id);
+
+        auto it = m_sessions.find(path.path());
+        if (it == m_sessions.end())
+            return;
+
+        m_users.remove(it->user, it->path);
+        m_sessions.erase(it);
+    }
+
+    void LogindSessions::propertiesChanged(const QString &interface, const QVariantMap &changedProperties, const QStringList &invalidatedProperties) {
+        if (interface != Logind::sessionIfaceName())
+            return;
+
+        const QString path = message().path();
+        if (!m_sessions.contains(path))
+            return;
+
+        update(path, changedProperties);
+
+        // the state follows from other properties and isn't always
+        // announced along with them
+        if (!changedProperties.contains(QStringLiteral("State")) || invalidatedProperties.contains(QStringLiteral("State")))
+            fetch(path, QStringLiteral("State"));
+    }
+
+    void LogindSessions::add(const QString &id, const QString &path, const QString &user, const QString &seat) {
+        if (m_sessions.contains(path))
+            return;
+
+        Session session;
+        session.id = id;
+        session.path = path;
+        session.user = user;
+        session.seat = seat;
+        m_sessions.insert(path, session);
+        if (!user.isEmpty())
+            m_users.insert(user, path);
+
+        // the rest isn't part of the announcement
+        fetch(path);
+    }
+
+    void LogindSessions::fetch(const QString &path, const QString &property) {
+        QDBusMessage message;
+        if (property.isEmpty()) {
+            message = QDBusMessage::createMethodCall(Logind::serviceName(), path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("GetAll"));
+            message << Logind::sessionIfaceName();
+        } else {
+            message = QDBusMessage::createMethodCall(Logind::serviceName(), path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("Get"));
+            message << Logind::sessionIfaceName() << property;
+        }
+
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusConnection::systemBus().asyncCall(message), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [=]() {
+            watcher->deleteLater();
+
+            // gone in the meantime
+            const QDBusMessage reply = watcher->reply();
+            if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty())
+                return;
+
+            const QVariant value = reply.arguments().first();
+            if (property.isEmpty())
+                update(path, qdbus_cast<QVariantMap>(value));
+            else
+                update(path, { { property, value.value<QDBusVariant>().variant() } });
+        });
+    }
+
+    void LogindSessions::update(const QString &path, const QVariantMap &properties) {
+        auto it = m_sessions.find(path);
+        if (it == m_sessions.end())
+            return;
+
+        Session &session = *it;
+        for (auto property = properties.constBegin(); property != properties.constEnd(); ++property) {
+            if (property.key() == QLatin1String("Name")) {
+                const QString user = property.value().toString();
+                if (user != session.user) {
+                    if (!session.user.isEmpty())
+                        m_users.remove(session.user, path);
+                    session.user = user;
+                    m_users.insert(user, path);
+                }
+            } else if (property.key() == QLatin1String("Service")) {
+                session.service = property.value().toString();
+            } else if (property.key() == QLatin1String("State")) {
+                session.state = property.value().toString();
+            } else if (property.key() == QLatin1String("Seat")) {
+                session.seat = qdbus_cast<NamedSeatPath>(property.value()).name;
+            }
+        }
+    }
+}
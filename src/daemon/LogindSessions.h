@@ -0,0 +1,78 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_LOGINDSESSIONS_H
+#define SDDM_LOGINDSESSIONS_H
+
+#include <QDBusContext>
+#include <QHash>
+#include <QObject>
+#include <QVariantMap>
+
+class QDBusObjectPath;
+
+namespace SDDM {
+    /**
+     * A copy of what logind (or ConsoleKit2) knows about the sessions,
+     * so that the login path doesn't have to ask it.
+     *
+     * The sessions are listed once when the daemon starts and kept up to
+     * date from SessionNew, SessionRemoved and the PropertiesChanged
+     * signals of the sessions, all without waiting for the bus.
+     */
+    class LogindSessions : public QObject, protected QDBusContext {
+        Q_OBJECT
+        Q_DISABLE_COPY(LogindSessions)
+    public:
+        struct Session {
+            QString id;
+            QString user;
+            QString service;
+            QString state;
+            QString seat;
+            QString path;
+        };
+
+        explicit LogindSessions(QObject *parent = nullptr);
+
+        /**
+         * Whether the initial list has come in.
+         */
+        bool isReady() const;
+
+        QList<Session> sessions(const QString &user) const;
+
+    private slots:
+        void sessionAdded(const QString &id, const QDBusObjectPath &path);
+        void sessionRemoved(const QString &id, const QDBusObjectPath &path);
+        void propertiesChanged(const QString &interface, const QVariantMap &changedProperties, const QStringList &invalidatedProperties);
+
+    private:
+        void add(const QString &id, const QString &path, const QString &user, const QString &seat);
+        void fetch(const QString &path, const QString &property = QString());
+        void update(const QString &path, const QVariantMap &properties);
+
+        // by object path
+        QHash<QString, Session> m_sessions;
+        QMultiHash<QString, QString> m_users;
+        bool m_ready { false };
+    };
+}
+
+#endif // SDDM_LOGINDSESSIONS_H
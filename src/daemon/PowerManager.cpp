@@ -24,9 +24,13 @@
 #include "Messages.h"
 
 #include <QDBusConnectionInterface>
-#include <QDBusInterface>
-#include <QDBusReply>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDebug>
 #include <QProcess>
+#include <QTimer>
+
+#include <memory>
 
 namespace SDDM {
     /************************************************/
@@ -34,79 +38,161 @@ namespace SDDM {
     /************************************************/
     class PowerManagerBackend {
     public:
-        PowerManagerBackend() {
+        PowerManagerBackend(PowerManager *manager, const QString &service, const QString &path, const QString &interface)
+            : m_manager(manager), m_service(service), m_path(path), m_interface(interface) {
+            // the answers may change along with the properties of the service
+            QDBusConnection::systemBus().connect(service, path, QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                 QStringLiteral("PropertiesChanged"), manager, SLOT(invalidate()));
         }
 
         virtual ~PowerManagerBackend() {
         }
 
-        virtual Capabilities capabilities() const = 0;
+        Capabilities capabilities() const {
+            return m_capabilities;
+        }
 
-        virtual void powerOff() const = 0;
-        virtual void reboot() const = 0;
-        virtual void suspend() const = 0;
-        virtual void hibernate() const = 0;
-        virtual void hybridSleep() const = 0;
-    };
+        void refresh() {
+            // ask everything at once, then update when the last answer is in
+            const QVector<Query> queries = this->queries();
+            const quint64 generation = ++m_generation;
+            auto pending = std::make_shared<int>(queries.size());
+            auto caps = std::make_shared<Capabilities>(fixedCapabilities());
 
-    /**********************************************/
-    /* UPOWER BACKEND                             */
-    /**********************************************/
+            if (queries.isEmpty()) {
+                update(*caps);
+                return;
+            }
 
-const QString UPOWER_PATH = QStringLiteral("/org/freedesktop/UPower");
-const QString UPOWER_SERVICE = QStringLiteral("org.freedesktop.UPower");
-const QString UPOWER_OBJECT = QStringLiteral("org.freedesktop.UPower");
+            for (const Query &query : queries) {
+                QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(asyncCall(query.method), m_manager);
+                const Capability capability = query.capability;
+                QObject::connect(watcher, &QDBusPendingCallWatcher::finished, m_manager, [=](QDBusPendingCallWatcher *watcher) {
+                    watcher->deleteLater();
 
-    class UPowerBackend : public PowerManagerBackend {
-    public:
-        UPowerBackend(const QString & service, const QString & path, const QString & interface) {
-            m_interface = new QDBusInterface(service, path, interface, QDBusConnection::systemBus());
-        }
+                    const QDBusMessage reply = watcher->reply();
+                    if (reply.type() == QDBusMessage::ReplyMessage && !reply.arguments().isEmpty() && allowed(reply.arguments().first()))
+                        *caps |= capability;
 
-        ~UPowerBackend() {
-            delete m_interface;
+                    // a newer refresh has been started in the meantime
+                    if (--*pending == 0 && generation == m_generation)
+                        update(*caps);
+                });
+            }
         }
 
-        Capabilities capabilities() const {
-            Capabilities caps = Capability::PowerOff | Capability::Reboot;
+        virtual void perform(Capability action) = 0;
 
-            QDBusReply<bool> reply;
+    protected:
+        struct Query {
+            QString method;
+            Capability capability;
+        };
 
-            // suspend
-            reply = m_interface->call(QStringLiteral("SuspendAllowed"));
-            if (reply.isValid() && reply.value())
-                caps |= Capability::Suspend;
+        // what is available without asking
+        virtual Capabilities fixedCapabilities() const {
+            return Capability::None;
+        }
 
-            // hibernate
-            reply = m_interface->call(QStringLiteral("HibernateAllowed"));
-            if (reply.isValid() && reply.value())
-                caps |= Capability::Hibernate;
+        virtual QVector<Query> queries() const = 0;
+        virtual bool allowed(const QVariant &answer) const = 0;
 
-            // return capabilities
-            return caps;
+        QDBusPendingCall asyncCall(const QString &method, const QVariantList &arguments = QVariantList()) const {
+            QDBusMessage message = QDBusMessage::createMethodCall(m_service, m_path, m_interface, method);
+            message.setArguments(arguments);
+            return QDBusConnection::systemBus().asyncCall(message);
         }
 
-        void powerOff() const {
-            QProcess::execute(mainConfig.HaltCommand.get());
+        // calls method without waiting for it, failures are logged
+        void call(const QString &method, const QVariantList &arguments = QVariantList()) {
+            QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(asyncCall(method, arguments), m_manager);
+            QObject::connect(watcher, &QDBusPendingCallWatcher::finished, m_manager, [method](QDBusPendingCallWatcher *watcher) {
+                watcher->deleteLater();
+                if (watcher->isError())
+                    qWarning() << "Power action" << method << "failed:" << watcher->error().message();
+            });
         }
 
-        void reboot() const {
-            QProcess::execute(mainConfig.RebootCommand.get());
+        // runs command without waiting for it, failures are logged
+        void execute(const QString &command) {
+            QProcess *process = new QProcess(m_manager);
+            QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), m_manager, [process, command](int exitCode, QProcess::ExitStatus exitStatus) {
+                process->deleteLater();
+                if (exitStatus != QProcess::NormalExit || exitCode != 0)
+                    qWarning() << "Power action" << command << "failed with exit code" << exitCode;
+            });
+            QObject::connect(process, &QProcess::errorOccurred, m_manager, [process, command](QProcess::ProcessError error) {
+                if (error != QProcess::FailedToStart)
+                    return;
+                qWarning() << "Failed to run" << command;
+                process->deleteLater();
+            });
+            process->start(command);
         }
 
-        void suspend() const {
-            m_interface->call(QStringLiteral("Suspend"));
+        PowerManager *m_manager { nullptr };
+
+    private:
+        void update(Capabilities caps) {
+            m_capabilities = caps;
+            QMetaObject::invokeMethod(m_manager, "updateCapabilities");
         }
 
-        void hibernate() const {
-            m_interface->call(QStringLiteral("Hibernate"));
+        QString m_service;
+        QString m_path;
+        QString m_interface;
+        Capabilities m_capabilities { Capability::None };
+        quint64 m_generation { 0 };
+    };
+
+    /**********************************************/
+    /* UPOWER BACKEND                             */
+    /**********************************************/
+
+const QString UPOWER_PATH = QStringLiteral("/org/freedesktop/UPower");
+const QString UPOWER_SERVICE = QStringLiteral("org.freedesktop.UPower");
+const QString UPOWER_OBJECT = QStringLiteral("org.freedesktop.UPower");
+
+    class UPowerBackend : public PowerManagerBackend {
+    public:
+        UPowerBackend(PowerManager *manager, const QString & service, const QString & path, const QString & interface)
+            : PowerManagerBackend(manager, service, path, interface) {
         }
 
-        void hybridSleep() const {
+        void perform(Capability action) {
+            switch (action) {
+            case Capability::PowerOff:
+                execute(mainConfig.HaltCommand.get());
+                break;
+            case Capability::Reboot:
+                execute(mainConfig.RebootCommand.get());
+                break;
+            case Capability::Suspend:
+                call(QStringLiteral("Suspend"));
+                break;
+            case Capability::Hibernate:
+                call(QStringLiteral("Hibernate"));
+                break;
+            default:
+                break;
+            }
         }
 
-    private:
-        QDBusInterface *m_interface { nullptr };
+    protected:
+        Capabilities fixedCapabilities() const {
+            return Capability::PowerOff | Capability::Reboot;
+        }
+
+        QVector<Query> queries() const {
+            return {
+                { QStringLiteral("SuspendAllowed"), Capability::Suspend },
+                { QStringLiteral("HibernateAllowed"), Capability::Hibernate },
+            };
+        }
+
+        bool allowed(const QVariant &answer) const {
+            return answer.toBool();
+        }
     };
 
     /**********************************************/
@@ -123,90 +209,74 @@ const QString CK2_OBJECT = QStringLiteral("org.freedesktop.ConsoleKit.Manager");
 
     class SeatManagerBackend : public PowerManagerBackend {
     public:
-        SeatManagerBackend(const QString & service, const QString & path, const QString & interface) {
-            m_interface = new QDBusInterface(service, path, interface, QDBusConnection::systemBus());
-        }
-
-        ~SeatManagerBackend() {
-            delete m_interface;
-        }
-
-        Capabilities capabilities() const {
-            Capabilities caps = Capability::None;
-
-            QDBusReply<QString> reply;
-
-            // power off
-            reply = m_interface->call(QStringLiteral("CanPowerOff"));
-            if (reply.isValid() && (reply.value() == QLatin1String("yes")))
-                caps |= Capability::PowerOff;
-
-            // reboot
-            reply = m_interface->call(QStringLiteral("CanReboot"));
-            if (reply.isValid() && (reply.value() == QLatin1String("yes")))
-                caps |= Capability::Reboot;
-
-            // suspend
-            reply = m_interface->call(QStringLiteral("CanSuspend"));
-            if (reply.isValid() && (reply.value() == QLatin1String("yes")))
-                caps |= Capability::Suspend;
-
-            // hibernate
-            reply = m_interface->call(QStringLiteral("CanHibernate"));
-            if (reply.isValid() && (reply.value() == QLatin1String("yes")))
-                caps |= Capability::Hibernate;
-
-            // hybrid sleep
-            reply = m_interface->call(QStringLiteral("CanHybridSleep"));
-            if (reply.isValid() && (reply.value() == QLatin1String("yes")))
-                caps |= Capability::HybridSleep;
-
-            // return capabilities
-            return caps;
+        SeatManagerBackend(PowerManager *manager, const QString & service, const QString & path, const QString & interface)
+            : PowerManagerBackend(manager, service, path, interface) {
         }
 
-        void powerOff() const {
-            m_interface->call(QStringLiteral("PowerOff"), true);
-        }
-
-        void reboot() const {
-            if (!daemonApp->testing())
-                m_interface->call(QStringLiteral("Reboot"), true);
-        }
-
-        void suspend() const {
-            m_interface->call(QStringLiteral("Suspend"), true);
+        void perform(Capability action) {
+            switch (action) {
+            case Capability::PowerOff:
+                call(QStringLiteral("PowerOff"), { true });
+                break;
+            case Capability::Reboot:
+                if (!daemonApp->testing())
+                    call(QStringLiteral("Reboot"), { true });
+                break;
+            case Capability::Suspend:
+                call(QStringLiteral("Suspend"), { true });
+                break;
+            case Capability::Hibernate:
+                call(QStringLiteral("Hibernate"), { true });
+                break;
+            case Capability::HybridSleep:
+                call(QStringLiteral("HybridSleep"), { true });
+                break;
+            default:
+                break;
+            }
         }
 
-        void hibernate() const {
-            m_interface->call(QStringLiteral("Hibernate"), true);
+    protected:
+        QVector<Query> queries() const {
+            return {
+                { QStringLiteral("CanPowerOff"), Capability::PowerOff },
+                { QStringLiteral("CanReboot"), Capability::Reboot },
+                { QStringLiteral("CanSuspend"), Capability::Suspend },
+                { QStringLiteral("CanHibernate"), Capability::Hibernate },
+                { QStringLiteral("CanHybridSleep"), Capability::HybridSleep },
+            };
         }
 
-        void hybridSleep() const {
-            m_interface->call(QStringLiteral("HybridSleep"), true);
+        bool allowed(const QVariant &answer) const {
+            return answer.toString() == QLatin1String("yes");
         }
-
-    private:
-        QDBusInterface *m_interface { nullptr };
     };
 
     /**********************************************/
     /* POWER MANAGER                              */
     /**********************************************/
-    PowerManager::PowerManager(QObject *parent) : QObject(parent) {
+    PowerManager::PowerManager(QObject *parent) : QObject(parent),
+        m_refreshTimer(new QTimer(this)) {
+        // properties tend to change several at a time
+        m_refreshTimer->setSingleShot(true);
+        m_refreshTimer->setInterval(100);
+        connect(m_refreshTimer, &QTimer::timeout, this, &PowerManager::refresh);
+
         QDBusConnectionInterface *interface = QDBusConnection::systemBus().interface();
 
         // check if login1 interface exists
         if (interface->isServiceRegistered(LOGIN1_SERVICE))
-            m_backends << new SeatManagerBackend(LOGIN1_SERVICE, LOGIN1_PATH, LOGIN1_OBJECT);
+            m_backends << new SeatManagerBackend(this, LOGIN1_SERVICE, LOGIN1_PATH, LOGIN1_OBJECT);
 
         // check if ConsoleKit2 interface exists
         if (interface->isServiceRegistered(CK2_SERVICE))
-            m_backends << new SeatManagerBackend(CK2_SERVICE, CK2_PATH, CK2_OBJECT);
+            m_backends << new SeatManagerBackend(this, CK2_SERVICE, CK2_PATH, CK2_OBJECT);
 
         // check if upower interface exists
         if (interface->isServiceRegistered(UPOWER_SERVICE))
-            m_backends << new UPowerBackend(UPOWER_SERVICE, UPOWER_PATH, UPOWER_OBJECT);
+            m_backends << new UPowerBackend(this, UPOWER_SERVICE, UPOWER_PATH, UPOWER_OBJECT);
+
+        refresh();
     }
 
     PowerManager::~PowerManager() {
@@ -215,71 +285,62 @@ const QString CK2_OBJECT = QStringLiteral("org.freedesktop.ConsoleKit.Manager");
     }
 
     Capabilities PowerManager::capabilities() const {
-        Capabilities caps = Capability::None;
+        return m_capabilities;
+    }
 
-        for (PowerManagerBackend *backend: m_backends)
-            caps |= backend->capabilities();
+    void PowerManager::refresh() {
+        for (PowerManagerBackend *backend: qAsConst(m_backends))
+            backend->refresh();
+    }
 
-        return caps;
+    void PowerManager::invalidate() {
+        m_refreshTimer->start();
     }
 
-    void PowerManager::powerOff() const {
-        if (daemonApp->testing())
-            return;
+    void PowerManager::updateCapabilities() {
+        Capabilities caps = Capability::None;
 
-        for (PowerManagerBackend *backend: m_backends) {
-            if (backend->capabilities() & Capability::PowerOff) {
-                backend->powerOff();
-                break;
-            }
-        }
-    }
+        for (PowerManagerBackend *backend: qAsConst(m_backends))
+            caps |= backend->capabilities();
 
-    void PowerManager::reboot() const {
-        if (daemonApp->testing())
+        if (caps == m_capabilities)
             return;
 
-        for (PowerManagerBackend *backend: m_backends) {
-            if (backend->capabilities() & Capability::Reboot) {
-                backend->reboot();
-                break;
-            }
-        }
+        m_capabilities = caps;
+        emit capabilitiesChanged(caps);
     }
 
-    void PowerManager::suspend() const {
+    void PowerManager::perform(Capability action) {
         if (daemonApp->testing())
             return;
 
-        for (PowerManagerBackend *backend: m_backends) {
-            if (backend->capabilities() & Capability::Suspend) {
-                backend->suspend();
-                break;
+        for (PowerManagerBackend *backend: qAsConst(m_backends)) {
+            if (backend->capabilities() & action) {
+                backend->perform(action);
+                return;
             }
         }
+
+        qWarning() << "No power manager backend is capable of action" << action;
     }
 
-    void PowerManager::hibernate() const {
-        if (daemonApp->testing())
-            return;
+    void PowerManager::powerOff() {
+        perform(Capability::PowerOff);
+    }
 
-        for (PowerManagerBackend *backend: m_backends) {
-            if (backend->capabilities() & Capability::Hibernate) {
-                backend->hibernate();
-                break;
-            }
-        }
+    void PowerManager::reboot() {
+        perform(Capability::Reboot);
     }
 
-    void PowerManager::hybridSleep() const {
-        if (daemonApp->testing())
-            return;
+    void PowerManager::suspend() {
+        perform(Capability::Suspend);
+    }
 
-        for (PowerManagerBackend *backend: m_backends) {
-            if (backend->capabilities() & Capability::HybridSleep) {
-                backend->hybridSleep();
-                break;
-            }
-        }
+    void PowerManager::hibernate() {
+        perform(Capability::Hibernate);
+    }
+
+    void PowerManager::hybridSleep() {
+        perform(Capability::HybridSleep);
     }
 }
@@ -25,9 +25,19 @@
 
 #include "Messages.h"
 
+class QTimer;
+
 namespace SDDM {
     class PowerManagerBackend;
 
+    /**
+     * Power actions of the available backends.
+     *
+     * The capabilities are cached and refreshed in the background when a
+     * backend announces changed properties, so asking for them never
+     * waits on the bus. Actions return right away, failures are only
+     * logged.
+     */
     class PowerManager : public QObject {
         Q_OBJECT
         Q_DISABLE_COPY(PowerManager)
@@ -37,15 +47,27 @@ namespace SDDM {
 
     public slots:
         Capabilities capabilities() const;
+        void refresh();
+
+        void powerOff();
+        void reboot();
+        void suspend();
+        void hibernate();
+        void hybridSleep();
 
-        void powerOff() const;
-        void reboot() const;
-        void suspend() const;
-        void hibernate() const;
-        void hybridSleep() const;
+    signals:
+        void capabilitiesChanged(Capabilities capabilities);
+
+    private slots:
+        void invalidate();
+        void updateCapabilities();
 
     private:
+        void perform(Capability action);
+
         QVector<PowerManagerBackend *> m_backends;
+        Capabilities m_capabilities { Capability::None };
+        QTimer *m_refreshTimer { nullptr };
     };
 }
 
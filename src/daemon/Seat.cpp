@@ -23,17 +23,33 @@
 #include "Configuration.h"
 #include "DaemonApp.h"
 #include "Display.h"
+#include "DisplayManager.h"
+#include "DisplayServer.h"
+#include "EnvironmentTemplate.h"
+#include "HelperZygote.h"
+#include "HookRunner.h"
 #include "XorgDisplayServer.h"
 #include "VirtualTerminal.h"
 
 #include <QDebug>
 #include <QFile>
+#include <QFileSystemWatcher>
 #include <QTimer>
 
 #include <functional>
+#include <memory>
+
+// backoff between attempts to start a display server, in milliseconds
+#define RETRY_DELAY 500
+#define RETRY_DELAY_MAX 8000
+#define RETRY_ATTEMPTS 8
 
 namespace SDDM {
-    Seat::Seat(const QString &name, QObject *parent) : QObject(parent), m_name(name) {
+    Seat::Seat(const QString &name, QObject *parent) : QObject(parent), m_name(name),
+        m_environment(new EnvironmentTemplate(name, daemonApp->displayManager()->seatPath(name), this)) {
+        if (mainConfig.PrestartHelper.get())
+            m_helperZygote = new HelperZygote(this);
+
         createDisplay();
     }
 
@@ -41,9 +57,22 @@ namespace SDDM {
         return m_name;
     }
 
+    HelperZygote *Seat::helperZygote() const {
+        return m_helperZygote;
+    }
+
+    EnvironmentTemplate *Seat::environment() const {
+        return m_environment;
+    }
+
     void Seat::createDisplay() {
-        //reload config if needed
-        mainConfig.load();
+        // the stop script of the previous display would run against the
+        // new one, which most likely gets the same display number
+        if (m_stopping > 0) {
+            qDebug() << "Waiting for the previous display to clean up...";
+            m_pendingDisplays++;
+            return;
+        }
 
         // create a new display
         qDebug() << "Adding new display...";
@@ -60,20 +89,93 @@ namespace SDDM {
     }
 
     void Seat::startDisplay(Display *display, int tryNr) {
+        // the display server may only find out later that it can't start,
+        // this attempt is accounted for once either way
+        auto failed = std::make_shared<QMetaObject::Connection>();
+        auto started = std::make_shared<QMetaObject::Connection>();
+        *failed = connect(display, &Display::startFailed, this, [=] {
+            QObject::disconnect(*failed);
+            QObject::disconnect(*started);
+            retryDisplay(display, tryNr);
+        });
+        // once it is up, failures belong to a later attempt
+        *started = connect(display->displayServer(), &DisplayServer::started, this, [=] {
+            QObject::disconnect(*failed);
+            QObject::disconnect(*started);
+        });
+
         if (display->start())
             return;
 
+        QObject::disconnect(*failed);
+        QObject::disconnect(*started);
+        retryDisplay(display, tryNr);
+    }
+
+    void Seat::retryDisplay(Display *display, int tryNr) {
         // It's possible that the system isn't ready yet (driver not loaded,
-        // device not enumerated, ...). It's not possible to tell when that changes,
-        // so try a few times with a delay in between.
+        // device not enumerated, ...). Try again as soon as a graphics device
+        // shows up, or after a growing delay in case nothing tells us.
         qWarning() << "Attempt" << tryNr << "starting the Display server on vt" << display->terminalId() << "failed";
 
-        if(tryNr >= 3) {
+        if (tryNr >= RETRY_ATTEMPTS) {
             qCritical() << "Could not start Display server on vt" << display->terminalId();
             return;
         }
 
-        QTimer::singleShot(2000, display, [=] { startDisplay(display, tryNr + 1); });
+        const int nextTry = tryNr + 1;
+        m_waiting.insert(display, nextTry);
+        watchDevices(true);
+
+        const int delay = qMin(RETRY_DELAY << (tryNr - 1), RETRY_DELAY_MAX);
+        QTimer::singleShot(delay, display, [=] {
+            // unless a device change got there first
+            if (m_waiting.value(display) != nextTry)
+                return;
+            m_waiting.remove(display);
+            watchDevices(!m_waiting.isEmpty());
+            startDisplay(display, nextTry);
+        });
+    }
+
+    void Seat::devicesChanged() {
+        if (m_waiting.isEmpty())
+            return;
+
+        qDebug() << "Graphics devices changed, starting the waiting displays";
+
+        const QHash<Display *, int> waiting = m_waiting;
+        m_waiting.clear();
+        for (auto it = waiting.constBegin(); it != waiting.constEnd(); ++it)
+            startDisplay(it.key(), it.value());
+
+        watchDevices(!m_waiting.isEmpty());
+    }
+
+    void Seat::watchDevices(bool watch) {
+        if (!watch) {
+            // may be called from its own signal
+            if (m_deviceWatcher)
+                m_deviceWatcher->deleteLater();
+            m_deviceWatcher = nullptr;
+            return;
+        }
+
+        if (m_deviceWatcher)
+            return;
+
+        // inotify on the device nodes, /dev itself for when there is no
+        // DRM device at all yet
+        m_deviceWatcher = new QFileSystemWatcher(this);
+        m_deviceWatcher->addPath(QStringLiteral("/dev"));
+        if (QFile::exists(QStringLiteral("/dev/dri")))
+            m_deviceWatcher->addPath(QStringLiteral("/dev/dri"));
+        connect(m_deviceWatcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &path) {
+            if (path == QLatin1String("/dev") && QFile::exists(QStringLiteral("/dev/dri")) &&
+                !m_deviceWatcher->directories().contains(QStringLiteral("/dev/dri")))
+                m_deviceWatcher->addPath(QStringLiteral("/dev/dri"));
+            devicesChanged();
+        });
     }
 
     void Seat::removeDisplay(Display* display) {
@@ -82,16 +184,34 @@ namespace SDDM {
 
         // remove display from list
         m_displays.removeAll(display);
+        m_waiting.remove(display);
+        watchDevices(!m_waiting.isEmpty());
 
         // stop the display
         display->blockSignals(true);
         display->stop();
         display->blockSignals(false);
 
+        HookRunner *hooks = display->displayServer()->stopHooks();
+        if (hooks && !hooks->isFinished()) {
+            m_stopping++;
+            connect(hooks, &HookRunner::finished, this, &Seat::stopHooksFinished);
+        }
+
         // delete display
         display->deleteLater();
     }
 
+    void Seat::stopHooksFinished() {
+        if (--m_stopping > 0)
+            return;
+
+        while (m_pendingDisplays > 0) {
+            m_pendingDisplays--;
+            createDisplay();
+        }
+    }
+
     void Seat::displayStopped() {
         Display *display = qobject_cast<Display *>(sender());
 
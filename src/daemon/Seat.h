@@ -20,11 +20,16 @@
 #ifndef SDDM_SEAT_H
 #define SDDM_SEAT_H
 
+#include <QHash>
 #include <QObject>
 #include <QVector>
 
+class QFileSystemWatcher;
+
 namespace SDDM {
     class Display;
+    class EnvironmentTemplate;
+    class HelperZygote;
 
     class Seat : public QObject {
         Q_OBJECT
@@ -33,20 +38,38 @@ namespace SDDM {
         explicit Seat(const QString &name, QObject *parent = 0);
 
         const QString &name() const;
+        HelperZygote *helperZygote() const;
+        EnvironmentTemplate *environment() const;
 
     public slots:
         void createDisplay();
         void removeDisplay(SDDM::Display* display);
 
+        // new graphics devices may be what failed displays were waiting for
+        void devicesChanged();
+
     private slots:
         void displayStopped();
+        void stopHooksFinished();
 
     private:
         void startDisplay(SDDM::Display *display, int tryNr = 1);
+        void retryDisplay(SDDM::Display *display, int tryNr);
+        void watchDevices(bool watch);
 
         QString m_name;
+        HelperZygote *m_helperZygote { nullptr };
+        EnvironmentTemplate *m_environment { nullptr };
 
         QVector<Display *> m_displays;
+
+        // displays that failed to start and the attempt they are up to
+        QHash<Display *, int> m_waiting;
+        QFileSystemWatcher *m_deviceWatcher { nullptr };
+
+        // stop scripts still running and displays waiting for them
+        int m_stopping { 0 };
+        int m_pendingDisplays { 0 };
     };
 }
 
@@ -157,7 +157,11 @@ namespace SDDM {
         auto logindSeat = new LogindSeat(name, objectPath, this);
         connect(logindSeat, &LogindSeat::canGraphicalChanged, this, [=]() {
             if (logindSeat->canGraphical()) {
-                createSeat(logindSeat->name());
+                // a seat we have already got another graphics device
+                if (Seat *seat = m_seats.value(logindSeat->name()))
+                    seat->devicesChanged();
+                else
+                    createSeat(logindSeat->name());
             } else {
                 removeSeat(logindSeat->name());
             }
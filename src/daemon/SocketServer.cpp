@@ -20,13 +20,23 @@
 
 #include "SocketServer.h"
 
+#include "Configuration.h"
 #include "DaemonApp.h"
+#include "FramedChannel.h"
 #include "Messages.h"
 #include "PowerManager.h"
 #include "SocketWriter.h"
+#include "UserDirectory.h"
 #include "Utils.h"
 
 #include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include <memory>
+
+// number of users sent to a greeter per event loop iteration
+#define USER_PAGE_SIZE 256
 
 namespace SDDM {
     SocketServer::SocketServer(QObject *parent) : QObject(parent) {
@@ -69,6 +79,9 @@ namespace SDDM {
 
         // connect signals
         connect(m_server, &QLocalServer::newConnection, this, &SocketServer::newConnection);
+        connect(daemonApp->powerManager(), &PowerManager::capabilitiesChanged, this, &SocketServer::capabilitiesChanged);
+        connect(daemonApp->userDirectory(), &UserDirectory::usersAdded, this, &SocketServer::usersAdded);
+        connect(daemonApp->userDirectory(), &UserDirectory::usersRemoved, this, &SocketServer::usersRemoved);
 
         // return success
         return true;
@@ -93,21 +106,29 @@ namespace SDDM {
     void SocketServer::newConnection() {
         // get pending connection
         QLocalSocket *socket = m_server->nextPendingConnection();
+        FramedChannel *channel = new FramedChannel(socket, socket);
 
         // connect signals
-        connect(socket, &QLocalSocket::readyRead, this, &SocketServer::readyRead);
+        connect(channel, &FramedChannel::frameReceived, this, &SocketServer::frameReceived);
+        connect(channel, &FramedChannel::timedOut, socket, &QLocalSocket::abort);
         connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
     }
 
-    void SocketServer::readyRead() {
-        QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    FramedChannel *SocketServer::channel(QLocalSocket *socket) {
+        return socket->findChild<FramedChannel *>(QString(), Qt::FindDirectChildrenOnly);
+    }
+
+    void SocketServer::frameReceived(const QByteArray &payload) {
+        FramedChannel *channel = qobject_cast<FramedChannel *>(sender());
 
-        // check socket
-        if (!socket)
+        // check channel
+        if (!channel)
             return;
 
+        QLocalSocket *socket = qobject_cast<QLocalSocket *>(channel->device());
+
         // input stream
-        QDataStream input(socket);
+        QDataStream input(payload);
 
         // read message
         quint32 message;
@@ -119,10 +140,10 @@ namespace SDDM {
                 qDebug() << "Message received from greeter: Connect";
 
                 // send capabilities
-                SocketWriter(socket) << quint32(DaemonMessages::Capabilities) << quint32(daemonApp->powerManager()->capabilities());
+                SocketWriter(channel) << quint32(DaemonMessages::Capabilities) << quint32(daemonApp->powerManager()->capabilities());
 
-                // send host name
-                SocketWriter(socket) << quint32(DaemonMessages::HostName) << daemonApp->hostName();
+                // send host name, goes out in the same write
+                SocketWriter(channel) << quint32(DaemonMessages::HostName) << daemonApp->hostName();
 
                 // emit signal
                 emit connected();
@@ -181,6 +202,27 @@ namespace SDDM {
                 daemonApp->powerManager()->hybridSleep();
             }
             break;
+            case GreeterMessages::ListUsers: {
+                // log message
+                qDebug() << "Message received from greeter: ListUsers";
+
+                // read how many users the greeter wants, 0 for all of them
+                quint32 limit;
+                input >> limit;
+
+                UserDirectory *directory = daemonApp->userDirectory();
+                if (directory->isReady()) {
+                    listUsers(channel, limit);
+                } else {
+                    // answer once the first scan is done
+                    auto ready = std::make_shared<QMetaObject::Connection>();
+                    *ready = connect(directory, &UserDirectory::ready, channel, [channel, limit, ready]() {
+                        QObject::disconnect(*ready);
+                        listUsers(channel, limit);
+                    });
+                }
+            }
+            break;
             default: {
                 // log message
                 qWarning() << "Unknown message" << message;
@@ -189,10 +231,56 @@ namespace SDDM {
     }
 
     void SocketServer::loginFailed(QLocalSocket *socket) {
-        SocketWriter(socket) << quint32(DaemonMessages::LoginFailed);
+        if (FramedChannel *c = channel(socket))
+            SocketWriter(c) << quint32(DaemonMessages::LoginFailed);
     }
 
     void SocketServer::loginSucceeded(QLocalSocket *socket) {
-        SocketWriter(socket) << quint32(DaemonMessages::LoginSucceeded);
+        if (FramedChannel *c = channel(socket))
+            SocketWriter(c) << quint32(DaemonMessages::LoginSucceeded);
+    }
+
+    void SocketServer::capabilitiesChanged(Capabilities capabilities) {
+        if (!m_server)
+            return;
+
+        // greeters that connected before the answers came in
+        for (FramedChannel *c : m_server->findChildren<FramedChannel *>())
+            SocketWriter(c) << quint32(DaemonMessages::Capabilities) << quint32(capabilities);
+    }
+
+    void SocketServer::usersAdded(const UserEntryList &users) {
+        if (!m_server)
+            return;
+
+        for (FramedChannel *c : m_server->findChildren<FramedChannel *>())
+            SocketWriter(c) << quint32(DaemonMessages::UsersAdded) << users;
+    }
+
+    void SocketServer::usersRemoved(const QStringList &names) {
+        if (!m_server)
+            return;
+
+        for (FramedChannel *c : m_server->findChildren<FramedChannel *>())
+            SocketWriter(c) << quint32(DaemonMessages::UsersRemoved) << names;
+    }
+
+    void SocketServer::listUsers(FramedChannel *channel, quint32 limit) {
+        UserEntryList users = daemonApp->userDirectory()->users();
+        const bool complete = limitUsers(users, int(limit), stateConfig.Last.User.get());
+
+        sendUserPage(channel, users, 0, limit, complete);
+    }
+
+    void SocketServer::sendUserPage(FramedChannel *channel, const UserEntryList &users, int offset, quint32 limit, bool complete) {
+        // the limit tells the greeter which of its requests this answers
+        SocketWriter(channel) << quint32(DaemonMessages::UserPage) << limit << quint32(users.size()) << complete << users.mid(offset, USER_PAGE_SIZE);
+
+        // let the greeter show the first page while the rest is on the way
+        if (offset + USER_PAGE_SIZE < users.size()) {
+            QTimer::singleShot(0, channel, [channel, users, offset, limit, complete]() {
+                sendUserPage(channel, users, offset + USER_PAGE_SIZE, limit, complete);
+            });
+        }
     }
 }
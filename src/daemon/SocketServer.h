@@ -24,12 +24,16 @@
 #include <QObject>
 #include <QString>
 
+#include "Messages.h"
 #include "Session.h"
+#include "UserEntry.h"
 
 class QLocalServer;
 class QLocalSocket;
 
 namespace SDDM {
+    class FramedChannel;
+
     class SocketServer : public QObject {
         Q_OBJECT
         Q_DISABLE_COPY(SocketServer)
@@ -43,11 +47,15 @@ namespace SDDM {
 
     private slots:
         void newConnection();
-        void readyRead();
+        void frameReceived(const QByteArray &payload);
 
         void loginFailed(QLocalSocket *socket);
         void loginSucceeded(QLocalSocket *socket);
 
+        void capabilitiesChanged(Capabilities capabilities);
+        void usersAdded(const SDDM::UserEntryList &users);
+        void usersRemoved(const QStringList &names);
+
     signals:
         void login(QLocalSocket *socket,
                    const QString &user, const QString &password,
@@ -55,6 +63,10 @@ namespace SDDM {
         void connected();
 
     private:
+        static FramedChannel *channel(QLocalSocket *socket);
+        static void listUsers(FramedChannel *channel, quint32 limit);
+        static void sendUserPage(FramedChannel *channel, const UserEntryList &users, int offset, quint32 limit, bool complete);
+
         QLocalServer *m_server { nullptr };
     };
 }
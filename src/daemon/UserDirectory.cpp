@@ -0,0 +1,247 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserDirectory.h"
+
+#include "Configuration.h"
+#include "UserIndex.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QRunnable>
+#include <QTimer>
+
+#include <algorithm>
+
+#define PASSWD_FILE "/etc/passwd"
+
+// delay before rescanning after /etc/passwd changed, editors and
+// useradd touch it more than once
+#define CHANGE_DELAY 1000
+
+namespace SDDM {
+    namespace {
+        class UserScan : public QRunnable {
+        public:
+            UserScan(UserDirectory *directory) : m_directory(directory),
+                m_minimumUid(mainConfig.Users.MinimumUid.get()),
+                m_maximumUid(mainConfig.Users.MaximumUid.get()),
+                m_hideUsers(mainConfig.Users.HideUsers.get()),
+                m_hideShells(mainConfig.Users.HideShells.get()),
+                m_facesDir(mainConfig.Theme.FacesDir.get()),
+                m_enableAvatars(mainConfig.Theme.EnableAvatars.get()),
+                m_forceAvatars(!mainConfig.Theme.EnableAvatars.isDefault()),
+                m_avatarsThreshold(mainConfig.Theme.DisableAvatarsThreshold.get()),
+                // getpwnam() isn't reentrant, look it up on the main thread
+                m_indexPath(UserIndex::defaultPath()) {
+            }
+
+            void run() override {
+                QElapsedTimer timer;
+                timer.start();
+
+                UserEntryList users;
+                struct passwd *current_pw;
+                setpwent();
+                while ((current_pw = getpwent()) != nullptr) {
+                    // skip entries with uids out of the range
+                    if (int(current_pw->pw_uid) < m_minimumUid || int(current_pw->pw_uid) > m_maximumUid)
+                        continue;
+
+                    // skip entries with user names in the hide users list
+                    if (m_hideUsers.contains(QString::fromLocal8Bit(current_pw->pw_name)))
+                        continue;
+
+                    // skip entries with shells in the hide shells list
+                    if (m_hideShells.contains(QString::fromLocal8Bit(current_pw->pw_shell)))
+                        continue;
+
+                    users << UserEntry(current_pw);
+                }
+                endpwent();
+
+                // sort users by username
+                std::sort(users.begin(), users.end(), [](const UserEntry &u1, const UserEntry &u2) { return u1.name < u2.name; });
+                // Remove duplicates in case we have several sources specified
+                // in nsswitch.conf(5).
+                auto newEnd = std::unique(users.begin(), users.end(), [](const UserEntry &u1, const UserEntry &u2) { return u1.name == u2.name; });
+                users.erase(newEnd, users.end());
+
+                // the system avatars the greeter would show first. The
+                // ones in home directories may be slow to get at, and they
+                // come before AccountsService, so the greeter looks those
+                // two up itself.
+                if (m_enableAvatars && (m_forceAvatars || users.size() <= m_avatarsThreshold)) {
+                    for (UserEntry &user : users) {
+                        const QString systemFace = QStringLiteral("%1/%2.face.icon").arg(m_facesDir).arg(user.name);
+                        if (QFile::exists(systemFace))
+                            user.icon = systemFace;
+                    }
+                }
+
+                qDebug() << "UserDirectory: Found" << users.size() << "users in" << timer.elapsed() << "ms";
+
+                // keep them for the greeters started after the next boot
+                UserEntryList indexed;
+                if (!UserIndex::read(m_indexPath, indexed) || indexed != users)
+                    UserIndex::write(m_indexPath, users);
+
+                QMetaObject::invokeMethod(m_directory, "scanned", Qt::QueuedConnection, Q_ARG(SDDM::UserEntryList, users));
+            }
+
+        private:
+            UserDirectory *m_directory { nullptr };
+            int m_minimumUid { 0 };
+            int m_maximumUid { 0 };
+            QStringList m_hideUsers;
+            QStringList m_hideShells;
+            QString m_facesDir;
+            bool m_enableAvatars { true };
+            bool m_forceAvatars { false };
+            int m_avatarsThreshold { 0 };
+            QString m_indexPath;
+        };
+    }
+
+    UserDirectory::UserDirectory(QObject *parent) : QObject(parent),
+        m_watcher(new QFileSystemWatcher(this)),
+        m_changeTimer(new QTimer(this)),
+        m_refreshTimer(new QTimer(this)) {
+        qRegisterMetaType<SDDM::UserEntryList>("SDDM::UserEntryList");
+
+        // getpwent() keeps its position in global state
+        m_pool.setMaxThreadCount(1);
+
+        // a replaced /etc/passwd shows up as a change of /etc
+        m_watcher->addPath(QFileInfo(QStringLiteral(PASSWD_FILE)).absolutePath());
+        watchPasswd();
+        connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &UserDirectory::passwdChanged);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &UserDirectory::passwdChanged);
+
+        m_changeTimer->setSingleShot(true);
+        m_changeTimer->setInterval(CHANGE_DELAY);
+        connect(m_changeTimer, &QTimer::timeout, this, &UserDirectory::refresh);
+
+        // accounts from other NSS sources come and go unnoticed
+        auto setInterval = [this](int seconds) {
+            if (seconds > 0)
+                m_refreshTimer->start(seconds * 1000);
+            else
+                m_refreshTimer->stop();
+        };
+        connect(m_refreshTimer, &QTimer::timeout, this, &UserDirectory::refresh);
+        setInterval(mainConfig.Users.RefreshInterval.get());
+        mainConfig.Users.RefreshInterval.onChanged(this, setInterval);
+
+        // the filters may change while the daemon is running
+        mainConfig.Users.MinimumUid.onChanged(this, [this](int) { refresh(); });
+        mainConfig.Users.MaximumUid.onChanged(this, [this](int) { refresh(); });
+        mainConfig.Users.HideUsers.onChanged(this, [this](const QStringList &) { refresh(); });
+        mainConfig.Users.HideShells.onChanged(this, [this](const QStringList &) { refresh(); });
+        mainConfig.Theme.FacesDir.onChanged(this, [this](const QString &) { refresh(); });
+        mainConfig.Theme.EnableAvatars.onChanged(this, [this](bool) { refresh(); });
+
+        refresh();
+    }
+
+    UserDirectory::~UserDirectory() {
+        // the scan posts its result to this object
+        m_pool.waitForDone();
+    }
+
+    bool UserDirectory::isReady() const {
+        return m_ready;
+    }
+
+    UserEntryList UserDirectory::users() const {
+        return m_users;
+    }
+
+    void UserDirectory::refresh() {
+        if (m_scanning) {
+            m_rescan = true;
+            return;
+        }
+
+        m_scanning = true;
+        m_pool.start(new UserScan(this));
+    }
+
+    void UserDirectory::scanned(const UserEntryList &users) {
+        m_scanning = false;
+
+        if (!m_ready) {
+            m_users = users;
+            m_ready = true;
+            emit ready();
+        } else {
+            // both lists are sorted by name
+            UserEntryList added;
+            QStringList removed;
+            auto oldIt = m_users.cbegin();
+            auto newIt = users.cbegin();
+            while (oldIt != m_users.cend() || newIt != users.cend()) {
+                if (newIt == users.cend() || (oldIt != m_users.cend() && oldIt->name < newIt->name)) {
+                    removed << (oldIt++)->name;
+                } else if (oldIt == m_users.cend() || newIt->name < oldIt->name) {
+                    added << *newIt++;
+                } else {
+                    if (*oldIt != *newIt)
+                        added << *newIt;
+                    ++oldIt;
+                    ++newIt;
+                }
+            }
+
+            m_users = users;
+            if (!removed.isEmpty())
+                emit usersRemoved(removed);
+            if (!added.isEmpty())
+                emit usersAdded(added);
+        }
+
+        if (m_rescan) {
+            m_rescan = false;
+            refresh();
+        }
+    }
+
+    void UserDirectory::passwdChanged() {
+        watchPasswd();
+
+        // most changes of /etc are about other files
+        const QDateTime modified = QFileInfo(QStringLiteral(PASSWD_FILE)).lastModified();
+        if (modified == m_passwdModified)
+            return;
+        m_passwdModified = modified;
+        m_changeTimer->start();
+    }
+
+    void UserDirectory::watchPasswd() {
+        // a replaced file is no longer watched
+        const QString path = QStringLiteral(PASSWD_FILE);
+        if (QFileInfo::exists(path) && !m_watcher->files().contains(path))
+            m_watcher->addPath(path);
+        if (!m_passwdModified.isValid())
+            m_passwdModified = QFileInfo(path).lastModified();
+    }
+}
@@ -0,0 +1,95 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERDIRECTORY_H
+#define SDDM_USERDIRECTORY_H
+
+#include <QDateTime>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "UserEntry.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace SDDM {
+    /**
+     * The accounts listed by the greeters, enumerated once for all of
+     * them.
+     *
+     * Walking all of NSS can take seconds when the accounts come from
+     * the network, so it is done off the event loop: when the daemon
+     * starts, whenever /etc/passwd or the user filters of the
+     * configuration change and periodically to pick up changes of the
+     * other sources. The snapshot is filtered, sorted by name and free
+     * of duplicates; the changes found by a later scan are announced as
+     * additions and removals.
+     */
+    class UserDirectory : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(UserDirectory)
+    public:
+        explicit UserDirectory(QObject *parent = nullptr);
+        ~UserDirectory();
+
+        /**
+         * Whether the first scan has finished.
+         */
+        bool isReady() const;
+
+        /**
+         * The accounts found by the last scan, sorted by name.
+         */
+        UserEntryList users() const;
+
+    public slots:
+        void refresh();
+
+    signals:
+        void ready();
+
+        /**
+         * Accounts that are new or whose entry changed.
+         */
+        void usersAdded(const SDDM::UserEntryList &users);
+        void usersRemoved(const QStringList &names);
+
+    private slots:
+        void scanned(const SDDM::UserEntryList &users);
+        void passwdChanged();
+
+    private:
+        void watchPasswd();
+
+        QThreadPool m_pool;
+        QFileSystemWatcher *m_watcher { nullptr };
+        QTimer *m_changeTimer { nullptr };
+        QTimer *m_refreshTimer { nullptr };
+        QDateTime m_passwdModified;
+
+        UserEntryList m_users;
+        bool m_ready { false };
+        bool m_scanning { false };
+        bool m_rescan { false };
+    };
+}
+
+#endif // SDDM_USERDIRECTORY_H
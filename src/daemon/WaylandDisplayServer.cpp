@@ -71,6 +71,7 @@ void WaylandDisplayServer::finished()
 
 void WaylandDisplayServer::setupDisplay()
 {
+    emit ready();
 }
 
 } // namespace SDDM
@@ -22,6 +22,7 @@
 
 #include "Configuration.h"
 #include "DaemonApp.h"
+#include "HookRunner.h"
 #include "Display.h"
 #include "SignalHandler.h"
 #include "Seat.h"
@@ -30,23 +31,36 @@
 #include <QFile>
 #include <QDir>
 #include <QProcess>
+#include <QSocketNotifier>
+#include <QTimer>
 #include <QUuid>
 
 #include <random>
 
 #include <xcb/xcb.h>
 
+#include <errno.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <unistd.h>
 
+// how long the X server may take to report its display number
+#define STARTUP_TIMEOUT 60000
+
 namespace SDDM {
-    XorgDisplayServer::XorgDisplayServer(Display *parent) : DisplayServer(parent) {
+    XorgDisplayServer::XorgDisplayServer(Display *parent) : DisplayServer(parent),
+        m_startTimer(new QTimer(this)) {
+        m_startTimer->setSingleShot(true);
+        m_startTimer->setInterval(STARTUP_TIMEOUT);
+        connect(m_startTimer, &QTimer::timeout, this, &XorgDisplayServer::startTimedOut);
+
         if (daemonApp->testing())
             m_xauth.setAuthDirectory(QStringLiteral("."));
         m_xauth.setup();
     }
 
     XorgDisplayServer::~XorgDisplayServer() {
+        finishStart();
         stop();
     }
 
@@ -62,6 +76,10 @@ namespace SDDM {
         return QStringLiteral("x11");
     }
 
+    HookRunner *XorgDisplayServer::stopHooks() const {
+        return m_stopHooks;
+    }
+
     QString XorgDisplayServer::cookie() const {
         return m_xauth.cookie();
     }
@@ -81,6 +99,13 @@ namespace SDDM {
 
         // delete process on finish
         connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &XorgDisplayServer::finished);
+        connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+            if (error != QProcess::FailedToStart)
+                return;
+            process->deleteLater();
+            process = nullptr;
+            abortStart(QStringLiteral("Failed to start display server process."));
+        });
 
         // log message
         qDebug() << "Display server starting...";
@@ -91,6 +116,8 @@ namespace SDDM {
         m_display = QStringLiteral(":0");
         if(!m_xauth.addCookie(m_display)) {
             qCritical() << "Failed to write xauth file";
+            delete process;
+            process = nullptr;
             return false;
         }
 
@@ -104,6 +131,9 @@ namespace SDDM {
         int pipeFds[2];
         if (pipe(pipeFds) != 0) {
             qCritical("Could not create pipe to start X server");
+            delete process;
+            process = nullptr;
+            return false;
         }
 
         // start display server
@@ -128,46 +158,47 @@ namespace SDDM {
         qDebug() << "Running:"
             << qPrintable(process->program())
             << qPrintable(process->arguments().join(QLatin1Char(' ')));
-        process->start();
 
-        // wait for display server to start
-        if (!process->waitForStarted()) {
-            // log message
-            qCritical() << "Failed to start display server process.";
+        // X writes the display number once it is ready, which may take
+        // seconds; the other seats are served in the meantime
+        m_displayFd = pipeFds[0];
+        fcntl(m_displayFd, F_SETFL, fcntl(m_displayFd, F_GETFL) | O_NONBLOCK);
+        fcntl(m_displayFd, F_SETFD, FD_CLOEXEC);
+        m_displayNumber.clear();
+        m_displayNotifier = new QSocketNotifier(m_displayFd, QSocketNotifier::Read, this);
+        connect(m_displayNotifier, &QSocketNotifier::activated, this, &XorgDisplayServer::readDisplayNumber);
+        m_startTimer->start();
 
-            // return fail
-            close(pipeFds[0]);
-            return false;
-        }
+        process->start();
 
         // close the other side of pipe in our process, otherwise reading
-        // from it may stuck even X server exit.
+        // from it may stuck even X server exit. The child has its copy
+        // once start() returns.
         close(pipeFds[1]);
 
-        QFile readPipe;
+        // return success, started() or failed() follows
+        return true;
+    }
 
-        if (!readPipe.open(pipeFds[0], QIODevice::ReadOnly)) {
-            qCritical("Failed to open pipe to start X Server");
+    void XorgDisplayServer::readDisplayNumber() {
+        char buffer[32];
+        ssize_t count;
+        while ((count = read(m_displayFd, buffer, sizeof(buffer))) > 0)
+            m_displayNumber.append(buffer, int(count));
 
-            close(pipeFds[0]);
-            stop();
-            return false;
-        }
-        QByteArray displayNumber = readPipe.readLine();
-        if (displayNumber.size() < 2) {
-            // X server gave nothing (or a whitespace).
-            qCritical("Failed to read display number from pipe");
+        if (count < 0 && errno == EAGAIN && !m_displayNumber.contains('\n'))
+            return;
 
-            close(pipeFds[0]);
-            stop();
-            return false;
+        // X closed the pipe, it exited or gave us a line
+        QByteArray displayNumber = m_displayNumber.left(m_displayNumber.indexOf('\n')).trimmed();
+        if (displayNumber.isEmpty()) {
+            // X server gave nothing (or a whitespace).
+            abortStart(QStringLiteral("Failed to read display number from pipe"));
+            return;
         }
-        displayNumber.prepend(QByteArray(":"));
-        displayNumber.remove(displayNumber.size() -1, 1); // trim trailing whitespace
-        m_display = QString::fromLocal8Bit(displayNumber);
 
-        // close our pipe
-        close(pipeFds[0]);
+        finishStart();
+        m_display = QStringLiteral(":") + QString::fromLocal8Bit(displayNumber);
 
         // The file is also used by the greeter, which does care about the
         // display number. Write the proper entry, if it's different.
@@ -175,20 +206,43 @@ namespace SDDM {
             if(!m_xauth.addCookie(m_display)) {
                 qCritical() << "Failed to write xauth file";
                 stop();
-                return false;
+                emit failed();
+                return;
             }
         }
         changeOwner(m_xauth.authPath());
 
-        emit started();
-
         // set flag
         m_started = true;
 
-        // return success
+        emit started();
+    }
+
+    void XorgDisplayServer::startTimedOut() {
+        abortStart(QStringLiteral("Display server did not report its display number in time"));
+    }
+
+    bool XorgDisplayServer::finishStart() {
+        if (!m_displayNotifier)
+            return false;
+
+        m_startTimer->stop();
+        delete m_displayNotifier;
+        m_displayNotifier = nullptr;
+        close(m_displayFd);
+        m_displayFd = -1;
         return true;
     }
 
+    void XorgDisplayServer::abortStart(const QString &reason) {
+        if (!finishStart())
+            return;
+
+        qCritical() << reason;
+        stop();
+        emit failed();
+    }
+
     void XorgDisplayServer::stop() {
         if (!process)
             return;
@@ -211,6 +265,9 @@ namespace SDDM {
             process = nullptr;
         }
 
+        // exited before it was ready
+        abortStart(QStringLiteral("Display server exited while starting"));
+
         // check flag
         if (!m_started)
             return;
@@ -221,47 +278,28 @@ namespace SDDM {
         // log message
         qDebug() << "Display server stopped.";
 
-        QString displayStopCommand = mainConfig.X11.DisplayStopCommand.get();
-
-        // create display setup script process
-        QProcess *displayStopScript = new QProcess();
-
-        // set process environment
-        QProcessEnvironment env;
-        env.insert(QStringLiteral("DISPLAY"), m_display);
-        env.insert(QStringLiteral("HOME"), QStringLiteral("/"));
-        env.insert(QStringLiteral("PATH"), mainConfig.Users.DefaultPath.get());
-        env.insert(QStringLiteral("SHELL"), QStringLiteral("/bin/sh"));
-        displayStopScript->setProcessEnvironment(env);
-
-        // start display stop script
-        qDebug() << "Running display stop script " << displayStopCommand;
-        displayStopScript->start(displayStopCommand);
-
-        // wait for finished
-        if (!displayStopScript->waitForFinished(5000))
-            displayStopScript->kill();
-
-        // clean up the script process
-        displayStopScript->deleteLater();
-        displayStopScript = nullptr;
-
-        // remove authority file
-        QFile::remove(m_xauth.authPath());
+        // run the stop script without holding up the other seats, it
+        // outlives this object if the display is going away. The seat
+        // holds back its next display until it is done, as that will
+        // most likely get the same display number.
+        HookRunner *hooks = new HookRunner(daemonApp);
+        m_stopHooks = hooks;
+        hooks->setProcessEnvironment(hookEnvironment());
+        hooks->add(QStringLiteral("Xstop"), mainConfig.X11.DisplayStopCommand.get(),
+                   mainConfig.X11.DisplayStopCommandTimeout.get() * 1000);
+
+        const QString authPath = m_xauth.authPath();
+        connect(hooks, &HookRunner::finished, hooks, [hooks, authPath] {
+            // remove authority file
+            QFile::remove(authPath);
+            hooks->deleteLater();
+        });
 
         // emit signal
-        emit stopped();
+        connect(hooks, &HookRunner::finished, this, &XorgDisplayServer::stopped);
     }
 
-    void XorgDisplayServer::setupDisplay() {
-        QString displayCommand = mainConfig.X11.DisplayCommand.get();
-
-        // create cursor setup process
-        QProcess *setCursor = new QProcess();
-        // create display setup script process
-        QProcess *displayScript = new QProcess();
-
-        // set process environment
+    QProcessEnvironment XorgDisplayServer::hookEnvironment() const {
         QProcessEnvironment env;
         env.insert(QStringLiteral("DISPLAY"), m_display);
         env.insert(QStringLiteral("HOME"), QStringLiteral("/"));
@@ -269,34 +307,26 @@ namespace SDDM {
         env.insert(QStringLiteral("XAUTHORITY"), m_xauth.authPath());
         env.insert(QStringLiteral("SHELL"), QStringLiteral("/bin/sh"));
         env.insert(QStringLiteral("XCURSOR_THEME"), mainConfig.Theme.CursorTheme.get());
-        setCursor->setProcessEnvironment(env);
-        displayScript->setProcessEnvironment(env);
-
-        qDebug() << "Setting default cursor";
-        setCursor->start(QStringLiteral("xsetroot -cursor_name left_ptr"));
-
-        // delete setCursor on finish
-        connect(setCursor, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), setCursor, &QProcess::deleteLater);
+        return env;
+    }
 
-        // wait for finished
-        if (!setCursor->waitForFinished(1000)) {
-            qWarning() << "Could not setup default cursor";
-            setCursor->kill();
+    void XorgDisplayServer::setupDisplay() {
+        delete m_setupHooks;
+        m_setupHooks = new HookRunner(this);
+        m_setupHooks->setProcessEnvironment(hookEnvironment());
+
+        m_setupHooks->add(QStringLiteral("Xsetup"), mainConfig.X11.DisplayCommand.get(),
+                          mainConfig.X11.DisplayCommandTimeout.get() * 1000,
+                          mainConfig.X11.DisplayCommandBlocking.get());
+        // the cursor is cosmetic, the greeter doesn't have to wait for it.
+        // Hooks run in order, so it goes last to not hold up Xsetup.
+        m_setupHooks->add(QStringLiteral("xsetroot"), QStringLiteral("xsetroot -cursor_name left_ptr"), 1000, false);
+
+        if (m_setupHooks->isReady()) {
+            emit ready();
+            return;
         }
-
-        // start display setup script
-        qDebug() << "Running display setup script " << displayCommand;
-        displayScript->start(displayCommand);
-
-        // delete displayScript on finish
-        connect(displayScript, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), displayScript, &QProcess::deleteLater);
-
-        // wait for finished
-        if (!displayScript->waitForFinished(30000))
-            displayScript->kill();
-
-        // reload config if needed
-        mainConfig.load();
+        connect(m_setupHooks, &HookRunner::ready, this, &XorgDisplayServer::ready);
     }
 
     void XorgDisplayServer::changeOwner(const QString &fileName) {
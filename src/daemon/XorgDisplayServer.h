@@ -24,9 +24,16 @@
 #include "DisplayServer.h"
 #include "XAuth.h"
 
+#include <QPointer>
+
 class QProcess;
+class QProcessEnvironment;
+class QSocketNotifier;
+class QTimer;
 
 namespace SDDM {
+    class HookRunner;
+
     class XorgDisplayServer : public DisplayServer {
         Q_OBJECT
         Q_DISABLE_COPY(XorgDisplayServer)
@@ -38,6 +45,7 @@ namespace SDDM {
         QString authPath() const;
 
         QString sessionType() const;
+        HookRunner *stopHooks() const;
 
         QString cookie() const;
 
@@ -47,11 +55,27 @@ namespace SDDM {
         void finished();
         void setupDisplay();
 
+    private slots:
+        void readDisplayNumber();
+        void startTimedOut();
+
     private:
         XAuth m_xauth;
 
         QProcess *process { nullptr };
 
+        // while waiting for the display number
+        int m_displayFd { -1 };
+        QByteArray m_displayNumber;
+        QSocketNotifier *m_displayNotifier { nullptr };
+        QTimer *m_startTimer { nullptr };
+
+        HookRunner *m_setupHooks { nullptr };
+        QPointer<HookRunner> m_stopHooks;
+
+        bool finishStart();
+        void abortStart(const QString &reason);
+        QProcessEnvironment hookEnvironment() const;
         void changeOwner(const QString &fileName);
     };
 }
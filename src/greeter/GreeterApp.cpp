@@ -20,13 +20,16 @@
 
 #include "GreeterApp.h"
 #include "Configuration.h"
+#include "ConfigWatcher.h"
 #include "GreeterProxy.h"
 #include "Constants.h"
 #include "ScreenModel.h"
 #include "SessionModel.h"
 #include "ThemeConfig.h"
 #include "ThemeMetadata.h"
+#include "UserIndex.h"
 #include "UserModel.h"
+#include "UserSearchModel.h"
 #include "KeyboardModel.h"
 
 #include "MessageHandler.h"
@@ -61,6 +64,9 @@ namespace SDDM {
             QCoreApplication::installTranslator(m_components_tranlator);
 
 
+        // Follow configuration changes
+        new ConfigWatcher(&mainConfig, this);
+
         // Create models
         m_sessionModel = new SessionModel();
         m_keyboard = new KeyboardModel();
@@ -186,6 +192,7 @@ namespace SDDM {
         view->rootContext()->setContextProperty(QStringLiteral("sessionModel"), m_sessionModel);
         view->rootContext()->setContextProperty(QStringLiteral("screenModel"), screenModel);
         view->rootContext()->setContextProperty(QStringLiteral("userModel"), m_userModel);
+        view->rootContext()->setContextProperty(QStringLiteral("userSearchModel"), m_userSearchModel);
         view->rootContext()->setContextProperty(QStringLiteral("config"), *m_themeConfig);
         view->rootContext()->setContextProperty(QStringLiteral("sddm"), m_proxy);
         view->rootContext()->setContextProperty(QStringLiteral("keyboard"), m_keyboard);
@@ -270,6 +277,25 @@ namespace SDDM {
         // Set session model on proxy
         m_proxy->setSessionModel(m_sessionModel);
 
+        // Get the users from the daemon, which lists them once for all
+        // greeters, or list them here when testing without one
+        if (!m_testing) {
+            m_userModel->preload();
+            m_proxy->setUserModel(m_userModel);
+        } else {
+            m_userModel->load();
+        }
+
+        // Search all users, also the ones left out of the user model. The
+        // index is there right away, the daemon sends the current list.
+        m_userSearchModel = new UserSearchModel(m_userModel, this);
+        UserEntryList users;
+        if (m_testing)
+            m_userSearchModel->setUsers(UserModel::listUsers());
+        else if (UserIndex::read(UserIndex::defaultPath(), users))
+            m_userSearchModel->setUsers(users);
+        m_proxy->setUserSearchModel(m_userSearchModel);
+
         // Create views
         const QList<QScreen *> screens = qGuiApp->primaryScreen()->virtualSiblings();
         for (QScreen *screen : screens)
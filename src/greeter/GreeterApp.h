@@ -34,6 +34,7 @@ namespace SDDM {
     class SessionModel;
     class ScreenModel;
     class UserModel;
+    class UserSearchModel;
     class GreeterProxy;
     class KeyboardModel;
 
@@ -74,6 +75,7 @@ namespace SDDM {
         ThemeConfig *m_themeConfig { nullptr };
         SessionModel *m_sessionModel { nullptr };
         UserModel *m_userModel { nullptr };
+        UserSearchModel *m_userSearchModel { nullptr };
         GreeterProxy *m_proxy { nullptr };
         KeyboardModel *m_keyboard { nullptr };
 
@@ -21,9 +21,12 @@
 #include "GreeterProxy.h"
 
 #include "Configuration.h"
+#include "FramedChannel.h"
 #include "Messages.h"
 #include "SessionModel.h"
 #include "SocketWriter.h"
+#include "UserModel.h"
+#include "UserSearchModel.h"
 
 #include <QLocalSocket>
 
@@ -31,7 +34,10 @@ namespace SDDM {
     class GreeterProxyPrivate {
     public:
         SessionModel *sessionModel { nullptr };
+        UserModel *userModel { nullptr };
+        UserSearchModel *userSearchModel { nullptr };
         QLocalSocket *socket { nullptr };
+        FramedChannel *channel { nullptr };
         QString hostName;
         bool canPowerOff { false };
         bool canReboot { false };
@@ -42,10 +48,12 @@ namespace SDDM {
 
     GreeterProxy::GreeterProxy(const QString &socket, QObject *parent) : QObject(parent), d(new GreeterProxyPrivate()) {
         d->socket = new QLocalSocket(this);
+        d->channel = new FramedChannel(d->socket, this);
         // connect signals
         connect(d->socket, &QLocalSocket::connected, this, &GreeterProxy::connected);
         connect(d->socket, &QLocalSocket::disconnected, this, &GreeterProxy::disconnected);
-        connect(d->socket, &QLocalSocket::readyRead, this, &GreeterProxy::readyRead);
+        connect(d->channel, &FramedChannel::frameReceived, this, &GreeterProxy::frameReceived);
+        connect(d->channel, &FramedChannel::timedOut, this, &GreeterProxy::timedOut);
         connect(d->socket, QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::error), this, &GreeterProxy::error);
 
         // connect to server
@@ -64,6 +72,27 @@ namespace SDDM {
         d->sessionModel = model;
     }
 
+    void GreeterProxy::setUserModel(UserModel *model) {
+        d->userModel = model;
+
+        // otherwise asked for when connected
+        if (isConnected())
+            SocketWriter(d->channel) << quint32(GreeterMessages::ListUsers) << d->userModel->requestLimit();
+    }
+
+    void GreeterProxy::setUserSearchModel(UserSearchModel *model) {
+        d->userSearchModel = model;
+
+        // otherwise asked for when connected
+        if (isConnected() && searchNeedsAllUsers())
+            SocketWriter(d->channel) << quint32(GreeterMessages::ListUsers) << quint32(0);
+    }
+
+    bool GreeterProxy::searchNeedsAllUsers() const {
+        // unless the user model gets all of them anyway
+        return d->userSearchModel && (!d->userModel || d->userModel->requestLimit() != 0);
+    }
+
     bool GreeterProxy::canPowerOff() const {
         return d->canPowerOff;
     }
@@ -89,23 +118,23 @@ namespace SDDM {
     }
 
     void GreeterProxy::powerOff() {
-        SocketWriter(d->socket) << quint32(GreeterMessages::PowerOff);
+        SocketWriter(d->channel) << quint32(GreeterMessages::PowerOff);
     }
 
     void GreeterProxy::reboot() {
-        SocketWriter(d->socket) << quint32(GreeterMessages::Reboot);
+        SocketWriter(d->channel) << quint32(GreeterMessages::Reboot);
     }
 
     void GreeterProxy::suspend() {
-        SocketWriter(d->socket) << quint32(GreeterMessages::Suspend);
+        SocketWriter(d->channel) << quint32(GreeterMessages::Suspend);
     }
 
     void GreeterProxy::hibernate() {
-        SocketWriter(d->socket) << quint32(GreeterMessages::Hibernate);
+        SocketWriter(d->channel) << quint32(GreeterMessages::Hibernate);
     }
 
     void GreeterProxy::hybridSleep() {
-        SocketWriter(d->socket) << quint32(GreeterMessages::HybridSleep);
+        SocketWriter(d->channel) << quint32(GreeterMessages::HybridSleep);
     }
 
     void GreeterProxy::login(const QString &user, const QString &password, const int sessionIndex) const {
@@ -121,10 +150,10 @@ namespace SDDM {
         QModelIndex index = d->sessionModel->index(sessionIndex, 0);
 
         // send command to the daemon
-        Session::Type type = static_cast<Session::Type>(d->sessionModel->data(index, SessionModel::TypeRole).toInt());
+        // what streaming a Session writes, without reading its file again
+        quint32 type = d->sessionModel->data(index, SessionModel::TypeRole).toUInt();
         QString name = d->sessionModel->data(index, SessionModel::FileRole).toString();
-        Session session(type, name);
-        SocketWriter(d->socket) << quint32(GreeterMessages::Login) << user << password << session;
+        SocketWriter(d->channel) << quint32(GreeterMessages::Login) << user << password << type << name;
     }
 
     void GreeterProxy::connected() {
@@ -132,7 +161,13 @@ namespace SDDM {
         qDebug() << "Connected to the daemon.";
 
         // send connected message
-        SocketWriter(d->socket) << quint32(GreeterMessages::Connect);
+        SocketWriter(d->channel) << quint32(GreeterMessages::Connect);
+
+        // ask for the users, goes out in the same write
+        if (d->userModel)
+            SocketWriter(d->channel) << quint32(GreeterMessages::ListUsers) << d->userModel->requestLimit();
+        if (searchNeedsAllUsers())
+            SocketWriter(d->channel) << quint32(GreeterMessages::ListUsers) << quint32(0);
     }
 
     void GreeterProxy::disconnected() {
@@ -144,70 +179,117 @@ namespace SDDM {
         qCritical() << "Socket error: " << d->socket->errorString();
     }
 
-    void GreeterProxy::readyRead() {
+    void GreeterProxy::timedOut() {
+        qCritical() << "Incomplete message from the daemon, disconnecting";
+        d->socket->abort();
+    }
+
+    void GreeterProxy::frameReceived(const QByteArray &payload) {
         // input stream
-        QDataStream input(d->socket);
-
-        while (input.device()->bytesAvailable()) {
-            // read message
-            quint32 message;
-            input >> message;
-
-            switch (DaemonMessages(message)) {
-                case DaemonMessages::Capabilities: {
-                    // log message
-                    qDebug() << "Message received from daemon: Capabilities";
-
-                    // read capabilities
-                    quint32 capabilities;
-                    input >> capabilities;
-
-                    // parse capabilities
-                    d->canPowerOff = capabilities & Capability::PowerOff;
-                    d->canReboot = capabilities & Capability::Reboot;
-                    d->canSuspend = capabilities & Capability::Suspend;
-                    d->canHibernate = capabilities & Capability::Hibernate;
-                    d->canHybridSleep = capabilities & Capability::HybridSleep;
-
-                    // emit signals
-                    emit canPowerOffChanged(d->canPowerOff);
-                    emit canRebootChanged(d->canReboot);
-                    emit canSuspendChanged(d->canSuspend);
-                    emit canHibernateChanged(d->canHibernate);
-                    emit canHybridSleepChanged(d->canHybridSleep);
-                }
-                break;
-                case DaemonMessages::HostName: {
-                    // log message
-                    qDebug() << "Message received from daemon: HostName";
-
-                    // read host name
-                    input >> d->hostName;
-
-                    // emit signal
-                    emit hostNameChanged(d->hostName);
-                }
-                break;
-                case DaemonMessages::LoginSucceeded: {
-                    // log message
-                    qDebug() << "Message received from daemon: LoginSucceeded";
-
-                    // emit signal
-                    emit loginSucceeded();
-                }
-                break;
-                case DaemonMessages::LoginFailed: {
-                    // log message
-                    qDebug() << "Message received from daemon: LoginFailed";
-
-                    // emit signal
-                    emit loginFailed();
-                }
-                break;
-                default: {
-                    // log message
-                    qWarning() << "Unknown message received from daemon.";
-                }
+        QDataStream input(payload);
+
+        // read message
+        quint32 message;
+        input >> message;
+
+        switch (DaemonMessages(message)) {
+            case DaemonMessages::Capabilities: {
+                // log message
+                qDebug() << "Message received from daemon: Capabilities";
+
+                // read capabilities
+                quint32 capabilities;
+                input >> capabilities;
+
+                // parse capabilities
+                d->canPowerOff = capabilities & Capability::PowerOff;
+                d->canReboot = capabilities & Capability::Reboot;
+                d->canSuspend = capabilities & Capability::Suspend;
+                d->canHibernate = capabilities & Capability::Hibernate;
+                d->canHybridSleep = capabilities & Capability::HybridSleep;
+
+                // emit signals
+                emit canPowerOffChanged(d->canPowerOff);
+                emit canRebootChanged(d->canReboot);
+                emit canSuspendChanged(d->canSuspend);
+                emit canHibernateChanged(d->canHibernate);
+                emit canHybridSleepChanged(d->canHybridSleep);
+            }
+            break;
+            case DaemonMessages::HostName: {
+                // log message
+                qDebug() << "Message received from daemon: HostName";
+
+                // read host name
+                input >> d->hostName;
+
+                // emit signal
+                emit hostNameChanged(d->hostName);
+            }
+            break;
+            case DaemonMessages::LoginSucceeded: {
+                // log message
+                qDebug() << "Message received from daemon: LoginSucceeded";
+
+                // emit signal
+                emit loginSucceeded();
+            }
+            break;
+            case DaemonMessages::LoginFailed: {
+                // log message
+                qDebug() << "Message received from daemon: LoginFailed";
+
+                // emit signal
+                emit loginFailed();
+            }
+            break;
+            case DaemonMessages::UserPage: {
+                // log message
+                qDebug() << "Message received from daemon: UserPage";
+
+                // read the page and the size of the whole list, the limit
+                // is the one it was asked for with
+                quint32 limit;
+                quint32 total;
+                bool complete;
+                UserEntryList page;
+                input >> limit >> total >> complete >> page;
+
+                if (d->userModel && limit == d->userModel->requestLimit())
+                    d->userModel->addUserPage(page, int(total), complete);
+                if (d->userSearchModel && limit == 0)
+                    d->userSearchModel->addUserPage(page, int(total));
+            }
+            break;
+            case DaemonMessages::UsersAdded: {
+                // log message
+                qDebug() << "Message received from daemon: UsersAdded";
+
+                UserEntryList users;
+                input >> users;
+
+                if (d->userModel)
+                    d->userModel->addUsers(users);
+                if (d->userSearchModel)
+                    d->userSearchModel->addUsers(users);
+            }
+            break;
+            case DaemonMessages::UsersRemoved: {
+                // log message
+                qDebug() << "Message received from daemon: UsersRemoved";
+
+                QStringList names;
+                input >> names;
+
+                if (d->userModel)
+                    d->userModel->removeUsers(names);
+                if (d->userSearchModel)
+                    d->userSearchModel->removeUsers(names);
+            }
+            break;
+            default: {
+                // log message
+                qWarning() << "Unknown message received from daemon.";
             }
         }
     }
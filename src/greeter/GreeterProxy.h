@@ -26,6 +26,8 @@ class QLocalSocket;
 
 namespace SDDM {
     class SessionModel;
+    class UserModel;
+    class UserSearchModel;
 
     class GreeterProxyPrivate;
     class GreeterProxy : public QObject {
@@ -54,6 +56,8 @@ namespace SDDM {
         bool isConnected() const;
 
         void setSessionModel(SessionModel *model);
+        void setUserModel(UserModel *model);
+        void setUserSearchModel(UserSearchModel *model);
 
     public slots:
         void powerOff();
@@ -67,7 +71,8 @@ namespace SDDM {
     private slots:
         void connected();
         void disconnected();
-        void readyRead();
+        void frameReceived(const QByteArray &payload);
+        void timedOut();
         void error();
 
     signals:
@@ -82,6 +87,8 @@ namespace SDDM {
         void loginSucceeded();
 
     private:
+        bool searchNeedsAllUsers() const;
+
         GreeterProxyPrivate *d { nullptr };
     };
 }
@@ -22,9 +22,11 @@
 
 #include "Configuration.h"
 
+#include <QDateTime>
 #include <QVector>
 #include <QProcessEnvironment>
 #include <QFileSystemWatcher>
+#include <QSet>
 
 namespace SDDM {
     class SessionModelPrivate {
@@ -34,27 +36,93 @@ namespace SDDM {
             sessions.clear();
         }
 
+        // whether TryExec names something that can be run
+        bool canExec(const QString &tryExec);
+        // where a session of the type from file sorts among the others
+        int insertPosition(Session::Type type, const QString &file) const;
+        int find(Session::Type type, const QString &file) const;
+
         int lastIndex { 0 };
         QStringList displayNames;
         QVector<Session *> sessions;
+
+        QStringList pathDirs;
+        // PATH lookups by executable name
+        QHash<QString, bool> executables;
+        // every session file read, shown or not, and when it was modified
+        QHash<QString, QDateTime> files;
     };
 
+    bool SessionModelPrivate::canExec(const QString &tryExec) {
+        if (tryExec.isEmpty())
+            return true;
+
+        QFileInfo fi(tryExec);
+        if (fi.isAbsolute())
+            return fi.exists() && fi.isExecutable();
+
+        auto it = executables.constFind(tryExec);
+        if (it != executables.constEnd())
+            return *it;
+
+        bool found = false;
+        for (const QString &path : qAsConst(pathDirs)) {
+            fi.setFile(QDir(path), tryExec);
+            if (fi.exists() && fi.isExecutable()) {
+                found = true;
+                break;
+            }
+        }
+        executables.insert(tryExec, found);
+        return found;
+    }
+
+    int SessionModelPrivate::insertPosition(Session::Type type, const QString &file) const {
+        // Wayland sessions first, each type ordered by file name
+        auto before = [](Session::Type type1, const QString &file1, Session::Type type2, const QString &file2) {
+            const bool wayland1 = type1 == Session::WaylandSession;
+            const bool wayland2 = type2 == Session::WaylandSession;
+            if (wayland1 != wayland2)
+                return wayland1;
+            return file1.compare(file2, Qt::CaseInsensitive) < 0;
+        };
+
+        int i = 0;
+        while (i < sessions.size() && before(sessions.at(i)->type(), sessions.at(i)->fileName(), type, file))
+            ++i;
+        return i;
+    }
+
+    int SessionModelPrivate::find(Session::Type type, const QString &file) const {
+        for (int i = 0; i < sessions.size(); ++i) {
+            if (sessions.at(i)->type() == type && sessions.at(i)->fileName() == file)
+                return i;
+        }
+        return -1;
+    }
+
     SessionModel::SessionModel(QObject *parent) : QAbstractListModel(parent), d(new SessionModelPrivate()) {
+        d->pathDirs = QProcessEnvironment::systemEnvironment().value(QStringLiteral("PATH")).split(QLatin1Char(':'));
+
         // initial population
-        beginResetModel();
-        populate(Session::WaylandSession, mainConfig.Wayland.SessionDir.get());
-        populate(Session::X11Session, mainConfig.X11.SessionDir.get());
-        endResetModel();
+        update(Session::WaylandSession, mainConfig.Wayland.SessionDir.get());
+        update(Session::X11Session, mainConfig.X11.SessionDir.get());
 
-        // refresh everytime a file is changed, added or removed
+        // update the files changed, added or removed
         QFileSystemWatcher *watcher = new QFileSystemWatcher(this);
-        connect(watcher, &QFileSystemWatcher::directoryChanged, [this](const QString &path) {
-            beginResetModel();
-            d->sessions.clear();
-            d->displayNames.clear();
-            populate(Session::WaylandSession, mainConfig.Wayland.SessionDir.get());
-            populate(Session::X11Session, mainConfig.X11.SessionDir.get());
-            endResetModel();
+        connect(watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &path) {
+            // an executable may have been installed along with the session
+            for (auto it = d->executables.begin(); it != d->executables.end();) {
+                if (!*it)
+                    it = d->executables.erase(it);
+                else
+                    ++it;
+            }
+
+            if (path == mainConfig.Wayland.SessionDir.get())
+                update(Session::WaylandSession, path);
+            if (path == mainConfig.X11.SessionDir.get())
+                update(Session::X11Session, path);
         });
         watcher->addPath(mainConfig.Wayland.SessionDir.get());
         watcher->addPath(mainConfig.X11.SessionDir.get());
@@ -116,51 +184,98 @@ namespace SDDM {
         return QVariant();
     }
 
-    void SessionModel::populate(Session::Type type, const QString &path) {
+    void SessionModel::update(Session::Type type, const QString &path) {
         // read session files
         QDir dir(path);
         dir.setNameFilters(QStringList() << QStringLiteral("*.desktop"));
         dir.setFilter(QDir::Files);
-        // read session
+
+        // names whose Wayland sessions may need a suffix now, or no more
+        QSet<QString> names;
+        auto removeRow = [this, &names](int i) {
+            beginRemoveRows(QModelIndex(), i, i);
+            Session *session = d->sessions.takeAt(i);
+            endRemoveRows();
+            d->displayNames.removeOne(session->displayName());
+            names.insert(session->displayName());
+            delete session;
+        };
+
+        // read the sessions that are new or changed
+        QSet<QString> present;
         const auto sessions = dir.entryList();
         for(const QString &session : sessions) {
-            if (!dir.exists(session))
+            const QString filePath = dir.absoluteFilePath(session);
+            const QDateTime modified = QFileInfo(filePath).lastModified();
+            present.insert(filePath);
+
+            auto it = d->files.constFind(filePath);
+            if (it != d->files.constEnd() && *it == modified)
                 continue;
+            d->files.insert(filePath, modified);
 
             Session *si = new Session(type, session);
-            bool execAllowed = true;
-            QFileInfo fi(si->tryExec());
-            if (fi.isAbsolute()) {
-                if (!fi.exists() || !fi.isExecutable())
-                    execAllowed = false;
-            } else {
-                execAllowed = false;
-                QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-                QString envPath = env.value(QStringLiteral("PATH"));
-                const QStringList pathList = envPath.split(QLatin1Char(':'));
-                for(const QString &path : pathList) {
-                    QDir pathDir(path);
-                    fi.setFile(pathDir, si->tryExec());
-                    if (fi.exists() && fi.isExecutable()) {
-                        execAllowed = true;
-                        break;
-                    }
-                }
+            const bool shown = !si->isHidden() && !si->isNoDisplay() && d->canExec(si->tryExec());
+            const int row = d->find(type, session);
+            if (row >= 0 && shown) {
+                // changed in place
+                Session *old = d->sessions.at(row);
+                d->displayNames.removeOne(old->displayName());
+                names.insert(old->displayName());
+                delete old;
+                d->sessions[row] = si;
+                d->displayNames.append(si->displayName());
+                names.insert(si->displayName());
+                emit dataChanged(index(row), index(row));
+                continue;
             }
+
+            if (row >= 0)
+                removeRow(row);
+
             // add to sessions list
-            if (!si->isHidden() && !si->isNoDisplay() && execAllowed) {
+            if (shown) {
+                const int i = d->insertPosition(type, session);
+                beginInsertRows(QModelIndex(), i, i);
+                d->sessions.insert(i, si);
+                endInsertRows();
                 d->displayNames.append(si->displayName());
-                d->sessions.push_back(si);
+                names.insert(si->displayName());
             } else {
                 delete si;
             }
         }
+
+        // drop the sessions whose files are gone
+        const QString dirPath = dir.absolutePath();
+        for (auto it = d->files.begin(); it != d->files.end();) {
+            if (QFileInfo(it.key()).absolutePath() != dirPath || present.contains(it.key())) {
+                ++it;
+                continue;
+            }
+
+            const int row = d->find(type, QFileInfo(it.key()).fileName());
+            if (row >= 0)
+                removeRow(row);
+            it = d->files.erase(it);
+        }
+
+        for (int i = 0; i < d->sessions.size(); ++i) {
+            if (names.contains(d->sessions.at(i)->displayName()))
+                emit dataChanged(index(i), index(i), { NameRole });
+        }
+
         // find out index of the last session
+        int lastIndex = 0;
         for (int i = 0; i < d->sessions.size(); ++i) {
             if (d->sessions.at(i)->fileName() == stateConfig.Last.Session.get()) {
-                d->lastIndex = i;
+                lastIndex = i;
                 break;
             }
         }
+        if (lastIndex != d->lastIndex) {
+            d->lastIndex = lastIndex;
+            emit lastIndexChanged();
+        }
     }
 }
@@ -33,7 +33,7 @@ namespace SDDM {
     class SessionModel : public QAbstractListModel {
         Q_OBJECT
         Q_DISABLE_COPY(SessionModel)
-        Q_PROPERTY(int lastIndex READ lastIndex CONSTANT)
+        Q_PROPERTY(int lastIndex READ lastIndex NOTIFY lastIndexChanged)
     public:
         enum SessionRole {
             DirectoryRole = Qt::UserRole + 1,
@@ -54,10 +54,13 @@ namespace SDDM {
         int rowCount(const QModelIndex &parent = QModelIndex()) const override;
         QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
+    signals:
+        void lastIndexChanged();
+
     private:
         SessionModelPrivate *d { nullptr };
 
-        void populate(Session::Type type, const QString &path);
+        void update(Session::Type type, const QString &path);
     };
 }
 
@@ -21,30 +21,72 @@
 
 #include "Constants.h"
 #include "Configuration.h"
+#include "UserIndex.h"
 
 #include <QFile>
 #include <QList>
+#include <QRunnable>
+#include <QSet>
 #include <QTextStream>
+#include <QThreadPool>
 #include <QStringList>
 
+#include <algorithm>
 #include <memory>
 #include <pwd.h>
 
+// number of avatars looked up at the same time, every lookup may be
+// waiting on a slow home directory
+#define ICON_LOOKUPS 2
+
 namespace SDDM {
+    static bool isListed(const struct passwd *pw) {
+        // skip entries with uids smaller than minimum uid
+        if (int(pw->pw_uid) < mainConfig.Users.MinimumUid.get())
+            return false;
+
+        // skip entries with uids greater than maximum uid
+        if (int(pw->pw_uid) > mainConfig.Users.MaximumUid.get())
+            return false;
+
+        // skip entries with user names in the hide users list
+        if (mainConfig.Users.HideUsers.get().contains(QString::fromLocal8Bit(pw->pw_name)))
+            return false;
+
+        // skip entries with shells in the hide shells list
+        if (mainConfig.Users.HideShells.get().contains(QString::fromLocal8Bit(pw->pw_shell)))
+            return false;
+
+        return true;
+    }
+
+    static void sortUsers(UserEntryList &entries) {
+        // sort users by username
+        std::sort(entries.begin(), entries.end(), [&](const UserEntry &u1, const UserEntry &u2) { return u1.name < u2.name; });
+        // Remove duplicates in case we have several sources specified
+        // in nsswitch.conf(5).
+        auto newEnd = std::unique(entries.begin(), entries.end(), [&](const UserEntry &u1, const UserEntry &u2) { return u1.name == u2.name; });
+        entries.erase(newEnd, entries.end());
+    }
+
     class User {
     public:
-        User(const struct passwd *data, const QString icon) :
-            name(QString::fromLocal8Bit(data->pw_name)),
-            realName(QString::fromLocal8Bit(data->pw_gecos).split(QLatin1Char(',')).first()),
-            homeDir(QString::fromLocal8Bit(data->pw_dir)),
-            uid(data->pw_uid),
-            gid(data->pw_gid),
-            // if shadow is used pw_passwd will be 'x' nevertheless, so this
-            // will always be true
-            needsPassword(strcmp(data->pw_passwd, "") != 0),
+        User(const UserEntry &entry, const QString icon) :
+            name(entry.name),
+            realName(entry.realName),
+            homeDir(entry.homeDir),
+            uid(entry.uid),
+            gid(entry.gid),
+            needsPassword(entry.needsPassword),
             icon(icon)
         {}
 
+        bool matches(const UserEntry &entry) const {
+            return name == entry.name && realName == entry.realName && homeDir == entry.homeDir &&
+                   uid == int(entry.uid) && gid == int(entry.gid) && needsPassword == entry.needsPassword &&
+                   (entry.icon.isEmpty() || icon == entry.icon);
+        }
+
         QString name;
         QString realName;
         QString homeDir;
@@ -52,105 +94,413 @@ namespace SDDM {
         int gid { 0 };
         bool needsPassword { false };
         QString icon;
+        // false until the avatar was looked up
+        bool iconResolved { true };
     };
 
     typedef std::shared_ptr<User> UserPtr;
 
+    /**
+     * Looks for the avatar of one user, the first of the candidates that
+     * exists, and reports it to the model along with the ones missing.
+     */
+    class IconLookup : public QRunnable {
+    public:
+        IconLookup(UserModel *model, const QString &name, const QStringList &candidates)
+            : m_model(model), m_name(name), m_candidates(candidates) {
+        }
+
+        void run() override {
+            QString icon;
+            QStringList missing;
+            for (const QString &path : qAsConst(m_candidates)) {
+                if (QFile::exists(path)) {
+                    icon = path;
+                    break;
+                }
+                missing << path;
+            }
+
+            QMetaObject::invokeMethod(m_model, "iconFound", Qt::QueuedConnection,
+                                      Q_ARG(QString, m_name), Q_ARG(QString, icon), Q_ARG(QStringList, missing));
+        }
+
+    private:
+        UserModel *m_model { nullptr };
+        QString m_name;
+        QStringList m_candidates;
+    };
+
     class UserModelPrivate {
     public:
+        // decides about avatars for a list of count users
+        void setUpIcons(int count);
+        UserPtr createUser(const UserEntry &entry) const;
+        // starts looking for the avatar of user
+        void requestIcon(const UserPtr &user);
+        // position of the first user not sorting before name
+        int lowerBound(const QString &name) const;
+
+        UserModel *q { nullptr };
+
         int lastIndex { 0 };
         QList<UserPtr> users;
         bool containsAllUsers { true };
+        bool needAllUsers { true };
+
+        // the list from the daemon is still coming in, changes have to
+        // wait for it
+        bool receiving { false };
+        int expected { 0 };
+        // with rows shown already, the list from the daemon is collected
+        // and compared to them once complete
+        bool staging { false };
+        UserEntryList received;
+        QList<std::pair<UserEntryList, QStringList>> pendingChanges;
+
+        QString defaultIcon;
+        QString facesDir;
+        bool avatarsEnabled { false };
+
+        // the avatars are only looked up once a row is shown
+        QThreadPool iconPool;
+        QSet<QString> pendingIcons;
+        QSet<QString> missingFiles;
     };
 
-    UserModel::UserModel(bool needAllUsers, QObject *parent) : QAbstractListModel(parent), d(new UserModelPrivate()) {
-        const QString facesDir = mainConfig.Theme.FacesDir.get();
+    void UserModelPrivate::setUpIcons(int count) {
+        facesDir = mainConfig.Theme.FacesDir.get();
         const QString themeDir = mainConfig.Theme.ThemeDir.get();
         const QString currentTheme = mainConfig.Theme.Current.get();
         const QString themeDefaultFace = QStringLiteral("%1/%2/faces/.face.icon").arg(themeDir).arg(currentTheme);
         const QString defaultFace = QStringLiteral("%1/.face.icon").arg(facesDir);
-        const QString iconURI = QStringLiteral("file://%1").arg(
+        defaultIcon = QStringLiteral("file://%1").arg(
                 QFile::exists(themeDefaultFace) ? themeDefaultFace : defaultFace);
 
+        avatarsEnabled = mainConfig.Theme.EnableAvatars.get();
+        if (avatarsEnabled && mainConfig.Theme.EnableAvatars.isDefault()) {
+            if (count > mainConfig.Theme.DisableAvatarsThreshold.get()) avatarsEnabled=false;
+        }
+    }
+
+    UserPtr UserModelPrivate::createUser(const UserEntry &entry) const {
+        UserPtr user { new User(entry, entry.icon.isEmpty() ? defaultIcon : entry.icon) };
+        user->iconResolved = !avatarsEnabled || !entry.icon.isEmpty();
+        return user;
+    }
+
+    void UserModelPrivate::requestIcon(const UserPtr &user) {
+        if (pendingIcons.contains(user->name))
+            return;
+
+        const QString userFace = QStringLiteral("%1/.face.icon").arg(user->homeDir);
+        const QString systemFace = QStringLiteral("%1/%2.face.icon").arg(facesDir).arg(user->name);
+        const QString accountsServiceFace = QStringLiteral("/var/lib/AccountsService/icons/%1").arg(user->name);
+
+        // If the home is encrypted it takes a lot of time to open
+        // up the greeter, therefore we try the system avatar first
+        QStringList candidates;
+        for (const QString &path : { systemFace, userFace, accountsServiceFace }) {
+            if (!missingFiles.contains(path))
+                candidates << path;
+        }
+
+        if (candidates.isEmpty()) {
+            user->iconResolved = true;
+            return;
+        }
+
+        pendingIcons.insert(user->name);
+        iconPool.start(new IconLookup(q, user->name, candidates));
+    }
+
+    int UserModelPrivate::lowerBound(const QString &name) const {
+        auto it = std::lower_bound(users.cbegin(), users.cend(), name, [](const UserPtr &user, const QString &name) { return user->name < name; });
+        return int(it - users.cbegin());
+    }
+
+    UserModel::UserModel(bool needAllUsers, QObject *parent) : QAbstractListModel(parent), d(new UserModelPrivate()) {
+        d->q = this;
+        d->needAllUsers = needAllUsers;
+        d->iconPool.setMaxThreadCount(ICON_LOOKUPS);
+    }
+
+    void UserModel::preload() {
+        UserEntryList entries;
+        if (!UserIndex::read(UserIndex::defaultPath(), entries))
+            return;
+
+        setContainsAllUsers(limitUsers(entries, int(requestLimit()), lastUser()));
+        d->setUpIcons(entries.count());
+
+        beginResetModel();
+        d->users.clear();
+        d->lastIndex = 0;
+        for (const UserEntry &entry : qAsConst(entries)) {
+            if (entry.name == lastUser())
+                d->lastIndex = d->users.size();
+            d->users << d->createUser(entry);
+        }
+        endResetModel();
+
+        emit countChanged();
+        emit lastIndexChanged();
+    }
+
+    void UserModel::load() {
+        populate();
+
+        // the filters may change while the greeter is running
+        mainConfig.Users.MinimumUid.onChanged(this, [this](int) { refresh(); });
+        mainConfig.Users.MaximumUid.onChanged(this, [this](int) { refresh(); });
+        mainConfig.Users.HideUsers.onChanged(this, [this](const QStringList &) { refresh(); });
+        mainConfig.Users.HideShells.onChanged(this, [this](const QStringList &) { refresh(); });
+    }
+
+    void UserModel::populate() {
+        UserEntryList entries;
         bool lastUserFound = false;
+        bool containsAllUsers = true;
 
         struct passwd *current_pw;
         setpwent();
         while ((current_pw = getpwent()) != nullptr) {
-
-            // skip entries with uids smaller than minimum uid
-            if (int(current_pw->pw_uid) < mainConfig.Users.MinimumUid.get())
-                continue;
-
-            // skip entries with uids greater than maximum uid
-            if (int(current_pw->pw_uid) > mainConfig.Users.MaximumUid.get())
-                continue;
-            // skip entries with user names in the hide users list
-            if (mainConfig.Users.HideUsers.get().contains(QString::fromLocal8Bit(current_pw->pw_name)))
-                continue;
-
-            // skip entries with shells in the hide shells list
-            if (mainConfig.Users.HideShells.get().contains(QString::fromLocal8Bit(current_pw->pw_shell)))
+            if (!isListed(current_pw))
                 continue;
 
-            // create user
-            UserPtr user { new User(current_pw, iconURI) };
-
             // add user
-            d->users << user;
+            entries << UserEntry(current_pw);
 
-            if (user->name == lastUser())
+            if (entries.last().name == lastUser())
                 lastUserFound = true;
 
-            if (!needAllUsers && d->users.count() > mainConfig.Theme.DisableAvatarsThreshold.get()) {
+            if (!d->needAllUsers && entries.count() > mainConfig.Theme.DisableAvatarsThreshold.get()) {
                 struct passwd *lastUserData;
                 // If the theme doesn't require that all users are present, try to add the data for lastUser at least
                 if(!lastUserFound && (lastUserData = getpwnam(qPrintable(lastUser()))))
-                    d->users << UserPtr(new User(lastUserData, themeDefaultFace));
+                    entries << UserEntry(lastUserData);
 
-                d->containsAllUsers = false;
+                containsAllUsers = false;
                 break;
             }
         }
 
         endpwent();
 
-        // sort users by username
-        std::sort(d->users.begin(), d->users.end(), [&](const UserPtr &u1, const UserPtr &u2) { return u1->name < u2->name; });
-        // Remove duplicates in case we have several sources specified
-        // in nsswitch.conf(5).
-        auto newEnd = std::unique(d->users.begin(), d->users.end(), [&](const UserPtr &u1, const UserPtr &u2) { return u1->name == u2->name; });
-        d->users.erase(newEnd, d->users.end());
+        sortUsers(entries);
+        setContainsAllUsers(containsAllUsers);
 
-        bool avatarsEnabled = mainConfig.Theme.EnableAvatars.get();
-        if (avatarsEnabled && mainConfig.Theme.EnableAvatars.isDefault()) {
-            if (d->users.count() > mainConfig.Theme.DisableAvatarsThreshold.get()) avatarsEnabled=false;
-        }
+        d->setUpIcons(entries.count());
 
         // find out index of the last user
-        for (int i = 0; i < d->users.size(); ++i) {
-            UserPtr user { d->users.at(i) };
-            if (user->name == stateConfig.Last.User.get())
-                d->lastIndex = i;
-
-            if (avatarsEnabled) {
-                const QString userFace = QStringLiteral("%1/.face.icon").arg(user->homeDir);
-                const QString systemFace = QStringLiteral("%1/%2.face.icon").arg(facesDir).arg(user->name);
-                const QString accountsServiceFace = QStringLiteral("/var/lib/AccountsService/icons/%1").arg(user->name);
-
-                // If the home is encrypted it takes a lot of time to open
-                // up the greeter, therefore we try the system avatar first
-                if (QFile::exists(systemFace))
-                    user->icon = systemFace;
-                else if (QFile::exists(userFace))
-                    user->icon = userFace;
-                else if (QFile::exists(accountsServiceFace))
-                    user->icon = accountsServiceFace;
+        for (const UserEntry &entry : qAsConst(entries)) {
+            if (entry.name == stateConfig.Last.User.get())
+                d->lastIndex = d->users.size();
+            d->users << d->createUser(entry);
+        }
+    }
+
+    UserEntryList UserModel::listUsers() {
+        UserEntryList entries;
+
+        struct passwd *current_pw;
+        setpwent();
+        while ((current_pw = getpwent()) != nullptr) {
+            if (isListed(current_pw))
+                entries << UserEntry(current_pw);
+        }
+        endpwent();
+
+        sortUsers(entries);
+        return entries;
+    }
+
+    void UserModel::refresh() {
+        beginResetModel();
+        // faces may have been added in the meantime
+        d->missingFiles.clear();
+        d->users.clear();
+        d->lastIndex = 0;
+        populate();
+        endResetModel();
+
+        emit countChanged();
+        emit lastIndexChanged();
+    }
+
+    quint32 UserModel::requestLimit() const {
+        // one more than the threshold, so that it is known to be exceeded
+        return d->needAllUsers ? 0 : quint32(mainConfig.Theme.DisableAvatarsThreshold.get() + 1);
+    }
+
+    QString UserModel::defaultIcon() const {
+        return d->defaultIcon;
+    }
+
+    void UserModel::addUserPage(const UserEntryList &page, int total, bool complete) {
+        if (!d->receiving) {
+            d->receiving = true;
+            d->expected = total;
+            setContainsAllUsers(complete);
+
+            // keep showing the rows there are until the list is complete
+            d->staging = !d->users.isEmpty();
+            d->received.clear();
+            if (!d->staging)
+                d->setUpIcons(total);
+        }
+
+        if (d->staging) {
+            d->received << page;
+        } else if (!page.isEmpty()) {
+            // pages come in sorted by name
+            const QString last = lastUser();
+            const int lastIndex = d->lastIndex;
+            beginInsertRows(QModelIndex(), d->users.size(), d->users.size() + page.size() - 1);
+            for (const UserEntry &entry : page) {
+                if (entry.name == last)
+                    d->lastIndex = d->users.size();
+                d->users << d->createUser(entry);
+            }
+            endInsertRows();
+
+            emit countChanged();
+            if (d->lastIndex != lastIndex)
+                emit lastIndexChanged();
+        }
+
+        if ((d->staging ? d->received.size() : d->users.size()) >= d->expected) {
+            d->receiving = false;
+
+            if (d->staging) {
+                d->staging = false;
+                d->setUpIcons(total);
+                reconcile(d->received);
+                d->received.clear();
+            }
+
+            const auto changes = d->pendingChanges;
+            d->pendingChanges.clear();
+            for (const auto &change : changes) {
+                removeUsers(change.second);
+                addUsers(change.first);
+            }
+        }
+    }
+
+    void UserModel::addUsers(const UserEntryList &users) {
+        if (d->receiving) {
+            d->pendingChanges << std::make_pair(users, QStringList());
+            return;
+        }
+
+        updateUsers(users, d->containsAllUsers);
+    }
+
+    void UserModel::updateUsers(const UserEntryList &users, bool insert) {
+        bool inserted = false;
+        for (const UserEntry &entry : users) {
+            const int i = d->lowerBound(entry.name);
+            if (i < d->users.size() && d->users.at(i)->name == entry.name) {
+                // the entry changed
+                d->users[i] = d->createUser(entry);
+                emit dataChanged(index(i), index(i));
+                continue;
+            }
+            if (!insert)
+                continue;
+
+            beginInsertRows(QModelIndex(), i, i);
+            d->users.insert(i, d->createUser(entry));
+            endInsertRows();
+            inserted = true;
+        }
+
+        if (inserted) {
+            emit countChanged();
+            updateLastIndex();
+        }
+    }
+
+    void UserModel::removeUsers(const QStringList &names) {
+        if (d->receiving) {
+            d->pendingChanges << std::make_pair(UserEntryList(), names);
+            return;
+        }
+
+        bool removed = false;
+        for (const QString &name : names) {
+            const int i = d->lowerBound(name);
+            if (i == d->users.size() || d->users.at(i)->name != name)
+                continue;
+
+            beginRemoveRows(QModelIndex(), i, i);
+            d->users.removeAt(i);
+            endRemoveRows();
+            removed = true;
+        }
+
+        if (removed) {
+            emit countChanged();
+            updateLastIndex();
+        }
+    }
+
+    void UserModel::reconcile(const UserEntryList &users) {
+        // both lists are sorted by name
+        UserEntryList changed;
+        QStringList removed;
+        auto oldIt = d->users.cbegin();
+        auto newIt = users.cbegin();
+        while (oldIt != d->users.cend() || newIt != users.cend()) {
+            if (newIt == users.cend() || (oldIt != d->users.cend() && (*oldIt)->name < newIt->name)) {
+                removed << (*oldIt++)->name;
+            } else if (oldIt == d->users.cend() || newIt->name < (*oldIt)->name) {
+                changed << *newIt++;
+            } else {
+                if (!(*oldIt)->matches(*newIt))
+                    changed << *newIt;
+                ++oldIt;
+                ++newIt;
             }
         }
+
+        removeUsers(removed);
+        updateUsers(changed, true);
+    }
+
+    void UserModel::updateLastIndex() {
+        const int i = d->lowerBound(lastUser());
+        const int lastIndex = (i < d->users.size() && d->users.at(i)->name == lastUser()) ? i : 0;
+        if (lastIndex == d->lastIndex)
+            return;
+
+        d->lastIndex = lastIndex;
+        emit lastIndexChanged();
+    }
+
+    void UserModel::iconFound(const QString &name, const QString &icon, const QStringList &missing) {
+        d->pendingIcons.remove(name);
+        for (const QString &path : missing)
+            d->missingFiles.insert(path);
+
+        const int i = d->lowerBound(name);
+        if (i == d->users.size() || d->users.at(i)->name != name)
+            return;
+
+        UserPtr user = d->users.at(i);
+        user->iconResolved = true;
+        if (icon.isEmpty())
+            return;
+
+        user->icon = icon;
+        emit dataChanged(index(i), index(i), { IconRole });
     }
 
     UserModel::~UserModel() {
+        // lookups still queued are of no use anymore
+        d->iconPool.clear();
+        d->iconPool.waitForDone();
         delete d;
     }
 
@@ -179,7 +529,7 @@ namespace SDDM {
     }
 
     QVariant UserModel::data(const QModelIndex &index, int role) const {
-        if (index.row() < 0 || index.row() > d->users.count())
+        if (index.row() < 0 || index.row() >= d->users.count())
             return QVariant();
 
         // get user
@@ -192,8 +542,12 @@ namespace SDDM {
             return user->realName;
         else if (role == HomeDirRole)
             return user->homeDir;
-        else if (role == IconRole)
+        else if (role == IconRole) {
+            // the default face until the lookup is done
+            if (!user->iconResolved)
+                d->requestIcon(user);
             return user->icon;
+        }
         else if (role == NeedsPasswordRole)
             return user->needsPassword;
 
@@ -208,4 +562,11 @@ namespace SDDM {
     bool UserModel::containsAllUsers() const {
         return d->containsAllUsers;
     }
+
+    void UserModel::setContainsAllUsers(bool containsAllUsers) {
+        if (d->containsAllUsers == containsAllUsers)
+            return;
+        d->containsAllUsers = containsAllUsers;
+        emit containsAllUsersChanged();
+    }
 }
@@ -24,17 +24,19 @@
 
 #include <QHash>
 
+#include "UserEntry.h"
+
 namespace SDDM {
     class UserModelPrivate;
 
     class UserModel : public QAbstractListModel {
         Q_OBJECT
         Q_DISABLE_COPY(UserModel)
-        Q_PROPERTY(int lastIndex READ lastIndex CONSTANT)
+        Q_PROPERTY(int lastIndex READ lastIndex NOTIFY lastIndexChanged)
         Q_PROPERTY(QString lastUser READ lastUser CONSTANT)
-        Q_PROPERTY(int count READ rowCount CONSTANT)
+        Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
         Q_PROPERTY(int disableAvatarsThreshold READ disableAvatarsThreshold CONSTANT)
-        Q_PROPERTY(bool containsAllUsers READ containsAllUsers CONSTANT)
+        Q_PROPERTY(bool containsAllUsers READ containsAllUsers NOTIFY containsAllUsersChanged)
     public:
         enum UserRoles {
             NameRole = Qt::UserRole + 1,
@@ -47,6 +49,46 @@ namespace SDDM {
         UserModel(bool needAllUsers, QObject *parent = 0);
         ~UserModel();
 
+        /**
+         * Shows the users the daemon found last time, until it sends
+         * the current list.
+         */
+        void preload();
+
+        /**
+         * Lists the users by enumerating them here, used when there is no
+         * daemon to get them from.
+         */
+        void load();
+
+        /**
+         * Every user that would be listed, looked up here.
+         */
+        static UserEntryList listUsers();
+
+        /**
+         * How many users to ask the daemon for, 0 for all of them.
+         */
+        quint32 requestLimit() const;
+
+        /**
+         * The face of users without an avatar.
+         */
+        QString defaultIcon() const;
+
+        /**
+         * Appends users from the daemon's list. The first page replaces
+         * the current list, changes received before the last page are
+         * applied after it.
+         */
+        void addUserPage(const UserEntryList &page, int total, bool complete);
+        /**
+         * Updates the given users. New ones are only inserted when the
+         * model lists all users, a limited model keeps the page it has.
+         */
+        void addUsers(const UserEntryList &users);
+        void removeUsers(const QStringList &names);
+
         QHash<int, QByteArray> roleNames() const override;
 
         const int lastIndex() const;
@@ -57,7 +99,23 @@ namespace SDDM {
 
         int disableAvatarsThreshold() const;
         bool containsAllUsers() const;
+
+    signals:
+        void lastIndexChanged();
+        void countChanged();
+        void containsAllUsersChanged();
+
+    private slots:
+        void iconFound(const QString &name, const QString &icon, const QStringList &missing);
+
     private:
+        void populate();
+        void refresh();
+        void reconcile(const UserEntryList &users);
+        void updateUsers(const UserEntryList &users, bool insert);
+        void setContainsAllUsers(bool containsAllUsers);
+        void updateLastIndex();
+
         UserModelPrivate *d { nullptr };
     };
 }
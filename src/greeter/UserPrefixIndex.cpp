@@ -0,0 +1,126 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserPrefixIndex.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+namespace SDDM {
+    namespace {
+        QStringList keysOf(const UserEntry &user) {
+            QStringList keys { user.name.toCaseFolded() };
+            const QStringList words = user.realName.toCaseFolded().split(QLatin1Char(' '), QString::SkipEmptyParts);
+            for (const QString &word : words) {
+                if (!keys.contains(word))
+                    keys << word;
+            }
+            return keys;
+        }
+    }
+
+    void UserPrefixIndex::setUsers(const UserEntryList &users) {
+        m_users = users;
+        m_ids.clear();
+        m_keys.clear();
+
+        for (int id = 0; id < m_users.size(); ++id) {
+            m_ids.insert(m_users.at(id).name, id);
+            for (const QString &key : keysOf(m_users.at(id)))
+                m_keys.append(Key { key, id });
+        }
+
+        std::sort(m_keys.begin(), m_keys.end(), [](const Key &k1, const Key &k2) { return k1.text < k2.text; });
+    }
+
+    void UserPrefixIndex::addUsers(const UserEntryList &users) {
+        for (const UserEntry &user : users) {
+            auto it = m_ids.constFind(user.name);
+            int id;
+            if (it != m_ids.constEnd()) {
+                id = *it;
+                removeKeys(id);
+                m_users[id] = user;
+            } else {
+                id = m_users.size();
+                m_users << user;
+                m_ids.insert(user.name, id);
+            }
+            insertKeys(id);
+        }
+    }
+
+    void UserPrefixIndex::removeUsers(const QStringList &names) {
+        for (const QString &name : names) {
+            auto it = m_ids.find(name);
+            if (it == m_ids.end())
+                continue;
+
+            // the entry stays, without keys, to keep the ids stable
+            removeKeys(*it);
+            m_ids.erase(it);
+        }
+    }
+
+    UserPrefixIndex::Range UserPrefixIndex::all() const {
+        return { 0, m_keys.size() };
+    }
+
+    UserPrefixIndex::Range UserPrefixIndex::find(const QString &prefix, const Range &within) const {
+        const QString folded = prefix.toCaseFolded();
+        auto begin = m_keys.cbegin() + within.begin;
+        auto end = m_keys.cbegin() + within.end;
+
+        // the keys starting with the prefix are the first ones not
+        // sorting before it
+        auto first = std::lower_bound(begin, end, folded, [](const Key &key, const QString &prefix) { return key.text < prefix; });
+        auto last = std::partition_point(first, end, [&folded](const Key &key) { return key.text.startsWith(folded); });
+
+        return { int(first - m_keys.cbegin()), int(last - m_keys.cbegin()) };
+    }
+
+    int UserPrefixIndex::userAt(int key) const {
+        return m_keys.at(key).user;
+    }
+
+    const UserEntry &UserPrefixIndex::user(int id) const {
+        return m_users.at(id);
+    }
+
+    void UserPrefixIndex::insertKeys(int id) {
+        for (const QString &text : keysOf(m_users.at(id))) {
+            auto it = std::upper_bound(m_keys.begin(), m_keys.end(), text, [](const QString &text, const Key &key) { return text < key.text; });
+            m_keys.insert(it, Key { text, id });
+        }
+    }
+
+    void UserPrefixIndex::removeKeys(int id) {
+        for (const QString &text : keysOf(m_users.at(id))) {
+            auto it = std::lower_bound(m_keys.begin(), m_keys.end(), text, [](const Key &key, const QString &text) { return key.text < text; });
+            while (it != m_keys.end() && it->text == text) {
+                if (it->user == id) {
+                    m_keys.erase(it);
+                    break;
+                }
+                ++it;
+            }
+        }
+    }
+}
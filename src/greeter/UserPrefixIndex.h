@@ -0,0 +1,86 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERPREFIXINDEX_H
+#define SDDM_USERPREFIXINDEX_H
+
+#include <QHash>
+
+#include "UserEntry.h"
+
+namespace SDDM {
+    /**
+     * Finds users by the beginning of their name or of any word of their
+     * real name, ignoring case.
+     *
+     * All the keys are kept in one array sorted by their text, so the
+     * keys starting with a prefix form a range that is found with two
+     * binary searches. Typing one more character narrows the previous
+     * range instead of searching all keys again. A user may appear once
+     * per matching key within a range.
+     */
+    class UserPrefixIndex {
+    public:
+        struct Range {
+            int begin { 0 };
+            int end { 0 };
+
+            bool isEmpty() const { return begin >= end; }
+        };
+
+        void setUsers(const UserEntryList &users);
+        /**
+         * Adds users, replacing the ones of the same name.
+         */
+        void addUsers(const UserEntryList &users);
+        void removeUsers(const QStringList &names);
+
+        /**
+         * The range of all keys.
+         */
+        Range all() const;
+
+        /**
+         * The keys starting with prefix, within the range of a shorter
+         * prefix.
+         */
+        Range find(const QString &prefix, const Range &within) const;
+
+        /**
+         * The user a key belongs to, ids stay valid until setUsers().
+         */
+        int userAt(int key) const;
+        const UserEntry &user(int id) const;
+
+    private:
+        struct Key {
+            QString text;
+            int user;
+        };
+
+        void insertKeys(int id);
+        void removeKeys(int id);
+
+        QVector<Key> m_keys;
+        QVector<UserEntry> m_users;
+        QHash<QString, int> m_ids;
+    };
+}
+
+#endif // SDDM_USERPREFIXINDEX_H
@@ -0,0 +1,151 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserSearchModel.h"
+
+#include "UserModel.h"
+
+namespace SDDM {
+    UserSearchModel::UserSearchModel(UserModel *userModel, QObject *parent) : QAbstractListModel(parent),
+        m_userModel(userModel) {
+    }
+
+    QString UserSearchModel::query() const {
+        return m_query;
+    }
+
+    void UserSearchModel::setQuery(const QString &query) {
+        if (query == m_query)
+            return;
+
+        // another character typed, only the current matches can match
+        const bool narrowing = !m_query.isEmpty() && query.startsWith(m_query, Qt::CaseInsensitive);
+        m_query = query;
+        search(narrowing ? m_matches : m_index.all());
+
+        emit queryChanged();
+    }
+
+    int UserSearchModel::pageSize() const {
+        return m_pageSize;
+    }
+
+    void UserSearchModel::setPageSize(int pageSize) {
+        if (pageSize == m_pageSize || pageSize <= 0)
+            return;
+
+        m_pageSize = pageSize;
+        emit pageSizeChanged();
+    }
+
+    void UserSearchModel::setUsers(const UserEntryList &users) {
+        m_index.setUsers(users);
+        search(m_index.all());
+    }
+
+    void UserSearchModel::addUserPage(const UserEntryList &page, int total) {
+        m_received << page;
+        if (m_received.size() < total)
+            return;
+
+        setUsers(m_received);
+        m_received.clear();
+    }
+
+    void UserSearchModel::addUsers(const UserEntryList &users) {
+        m_index.addUsers(users);
+        search(m_index.all());
+    }
+
+    void UserSearchModel::removeUsers(const QStringList &names) {
+        m_index.removeUsers(names);
+        search(m_index.all());
+    }
+
+    void UserSearchModel::search(const UserPrefixIndex::Range &within) {
+        beginResetModel();
+        m_matches = m_query.isEmpty() ? UserPrefixIndex::Range() : m_index.find(m_query, within);
+        m_next = m_matches.begin;
+        m_shown.clear();
+        m_rows = nextPage();
+        endResetModel();
+
+        emit countChanged();
+    }
+
+    QHash<int, QByteArray> UserSearchModel::roleNames() const {
+        return m_userModel->roleNames();
+    }
+
+    int UserSearchModel::rowCount(const QModelIndex &parent) const {
+        return parent.isValid() ? 0 : m_rows.size();
+    }
+
+    QVariant UserSearchModel::data(const QModelIndex &index, int role) const {
+        if (index.row() < 0 || index.row() >= m_rows.size())
+            return QVariant();
+
+        const UserEntry &user = m_index.user(m_rows.at(index.row()));
+
+        if (role == UserModel::NameRole)
+            return user.name;
+        else if (role == UserModel::RealNameRole)
+            return user.realName;
+        else if (role == UserModel::HomeDirRole)
+            return user.homeDir;
+        else if (role == UserModel::IconRole)
+            return user.icon.isEmpty() ? m_userModel->defaultIcon() : user.icon;
+        else if (role == UserModel::NeedsPasswordRole)
+            return user.needsPassword;
+
+        return QVariant();
+    }
+
+    bool UserSearchModel::canFetchMore(const QModelIndex &parent) const {
+        return !parent.isValid() && m_next < m_matches.end;
+    }
+
+    void UserSearchModel::fetchMore(const QModelIndex &parent) {
+        if (parent.isValid())
+            return;
+
+        const QVector<int> page = nextPage();
+        if (page.isEmpty())
+            return;
+
+        beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + page.size() - 1);
+        m_rows << page;
+        endInsertRows();
+
+        emit countChanged();
+    }
+
+    QVector<int> UserSearchModel::nextPage() {
+        // a user matching with several words comes up once
+        QVector<int> page;
+        for (; m_next < m_matches.end && page.size() < m_pageSize; ++m_next) {
+            const int id = m_index.userAt(m_next);
+            if (!m_shown.contains(id)) {
+                m_shown.insert(id);
+                page << id;
+            }
+        }
+        return page;
+    }
+}
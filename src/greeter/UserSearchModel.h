@@ -0,0 +1,93 @@
+/***************************************************************************
+* Copyright (c) 2026 SDDM contributors
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERSEARCHMODEL_H
+#define SDDM_USERSEARCHMODEL_H
+
+#include <QAbstractListModel>
+#include <QSet>
+
+#include "UserPrefixIndex.h"
+
+namespace SDDM {
+    class UserModel;
+
+    /**
+     * The users matching what has been typed so far, for themes that
+     * don't list every user. It holds all the users the daemon knows,
+     * also when the user model has been cut down, and hands out the
+     * matches a page at a time through fetchMore().
+     */
+    class UserSearchModel : public QAbstractListModel {
+        Q_OBJECT
+        Q_DISABLE_COPY(UserSearchModel)
+        Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+        Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+        Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    public:
+        explicit UserSearchModel(UserModel *userModel, QObject *parent = nullptr);
+
+        QString query() const;
+        void setQuery(const QString &query);
+
+        int pageSize() const;
+        void setPageSize(int pageSize);
+
+        void setUsers(const UserEntryList &users);
+        /**
+         * Collects the full list from the daemon, it replaces the users
+         * once the last page is in.
+         */
+        void addUserPage(const UserEntryList &page, int total);
+        void addUsers(const UserEntryList &users);
+        void removeUsers(const QStringList &names);
+
+        QHash<int, QByteArray> roleNames() const override;
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+        QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+        bool canFetchMore(const QModelIndex &parent) const override;
+        void fetchMore(const QModelIndex &parent) override;
+
+    signals:
+        void queryChanged();
+        void pageSizeChanged();
+        void countChanged();
+
+    private:
+        void search(const UserPrefixIndex::Range &within);
+        QVector<int> nextPage();
+
+        UserModel *m_userModel { nullptr };
+        UserPrefixIndex m_index;
+        QString m_query;
+        int m_pageSize { 50 };
+
+        // keys matching the query, the ones before m_next are shown
+        UserPrefixIndex::Range m_matches;
+        int m_next { 0 };
+        QVector<int> m_rows;
+        QSet<int> m_shown;
+
+        UserEntryList m_received;
+    };
+}
+
+#endif // SDDM_USERSEARCHMODEL_H
@@ -63,6 +63,9 @@ namespace SDDM {
         m_greeter = on;
     }
 
+    void Backend::preload() {
+    }
+
     bool Backend::openSession() {
         struct passwd *pw;
         pw = getpwnam(qPrintable(qobject_cast<HelperApp*>(parent())->user()));
@@ -39,6 +39,12 @@ namespace SDDM {
         void setDisplayServer(bool on = true);
         void setGreeter(bool on = true);
 
+        /**
+        * Does whatever can be done before the user is known, to have
+        * \ref start return sooner later on.
+        */
+        virtual void preload();
+
     public slots:
         virtual bool start(const QString &user = QString()) = 0;
         virtual bool authenticate() = 0;
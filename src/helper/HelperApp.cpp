@@ -23,6 +23,7 @@
 #include "Configuration.h"
 #include "UserSession.h"
 #include "SafeDataStream.h"
+#include "AuthWire.h"
 
 #include "MessageHandler.h"
 #include "VirtualTerminal.h"
@@ -33,6 +34,7 @@
 #include <QtNetwork/QLocalSocket>
 
 #include <iostream>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/time.h>
@@ -51,8 +53,18 @@ namespace SDDM {
     void HelperApp::setUp() {
         QStringList args = QCoreApplication::arguments();
         QString server;
+        int fd = -1;
         int pos;
 
+        if ((pos = args.indexOf(QStringLiteral("--fd"))) >= 0) {
+            if (pos >= args.length() - 1) {
+                qCritical() << "This application is not supposed to be executed manually";
+                exit(Auth::HELPER_OTHER_ERROR);
+                return;
+            }
+            fd = args[pos + 1].toInt();
+        }
+
         if ((pos = args.indexOf(QStringLiteral("--socket"))) >= 0) {
             if (pos >= args.length() - 1) {
                 qCritical() << "This application is not supposed to be executed manually";
@@ -71,11 +83,51 @@ namespace SDDM {
             m_id = QString(args[pos + 1]).toLongLong();
         }
 
+        if (!setUpSession(args))
+            return;
+
+        if (fd < 0 && (server.isEmpty() || m_id <= 0)) {
+            qCritical() << "This application is not supposed to be executed manually";
+            exit(Auth::HELPER_OTHER_ERROR);
+            return;
+        }
+
+        connect(m_session, &UserSession::finished, this, &HelperApp::sessionFinished);
+
+        // the daemon handed us our end of a connected socket pair
+        if (fd >= 0) {
+            // nothing started from here needs it
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+            if (!m_socket->setSocketDescriptor(fd)) {
+                qCritical() << "Couldn't use the socket passed by the daemon:" << m_socket->errorString();
+                exit(Auth::HELPER_OTHER_ERROR);
+                return;
+            }
+
+            // started ahead of time, wait for the daemon to tell us what to do
+            if (args.contains(QStringLiteral("--zygote"))) {
+                m_backend->preload();
+                connect(m_socket, &QLocalSocket::readyRead, this, &HelperApp::startRequested);
+                connect(m_socket, &QLocalSocket::disconnected, this, &QCoreApplication::quit);
+                return;
+            }
+
+            doAuth();
+            return;
+        }
+
+        connect(m_socket, &QLocalSocket::connected, this, &HelperApp::doAuth);
+        m_socket->connectToServer(server, QIODevice::ReadWrite | QIODevice::Unbuffered);
+    }
+
+    bool HelperApp::setUpSession(const QStringList &args) {
+        int pos;
+
         if ((pos = args.indexOf(QStringLiteral("--start"))) >= 0) {
             if (pos >= args.length() - 1) {
                 qCritical() << "This application is not supposed to be executed manually";
                 exit(Auth::HELPER_OTHER_ERROR);
-                return;
+                return false;
             }
             m_session->setPath(args[pos + 1]);
         }
@@ -84,7 +136,7 @@ namespace SDDM {
             if (pos >= args.length() - 1) {
                 qCritical() << "This application is not supposed to be executed manually";
                 exit(Auth::HELPER_OTHER_ERROR);
-                return;
+                return false;
             }
             m_user = args[pos + 1];
         }
@@ -93,7 +145,7 @@ namespace SDDM {
             if (pos >= args.length() - 1) {
                 qCritical() << "This application is not supposed to be executed manually";
                 exit(Auth::HELPER_OTHER_ERROR);
-                return;
+                return false;
             }
             m_session->setDisplayServerCommand(args[pos + 1]);
             m_backend->setDisplayServer(true);
@@ -107,23 +159,43 @@ namespace SDDM {
             m_backend->setGreeter(true);
         }
 
-        if (server.isEmpty() || m_id <= 0) {
-            qCritical() << "This application is not supposed to be executed manually";
+        return true;
+    }
+
+    void HelperApp::startRequested() {
+        // from now on the conversation is driven from here
+        m_socket->disconnect(this);
+
+        QStringList args;
+        SafeDataStream str(m_socket);
+        str.receive();
+        WireReader in(str.frame());
+        in >> args;
+        if (!in.isValid() || in.message() != START) {
+            qCritical() << "Received a wrong opcode instead of START:" << in.message();
             exit(Auth::HELPER_OTHER_ERROR);
             return;
         }
 
-        connect(m_socket, &QLocalSocket::connected, this, &HelperApp::doAuth);
-        connect(m_session, &UserSession::finished, this, &HelperApp::sessionFinished);
-        m_socket->connectToServer(server, QIODevice::ReadWrite | QIODevice::Unbuffered);
+        // we may have been waiting for a while, pick up any changes since
+        mainConfig.load();
+
+        if (!setUpSession(args))
+            return;
+
+        doAuth();
     }
 
     void HelperApp::doAuth() {
-        SafeDataStream str(m_socket);
-        str << Msg::HELLO << m_id;
-        str.send();
-        if (str.status() != QDataStream::Ok)
-            qCritical() << "Couldn't write initial message:" << str.status();
+        // only a shared server needs to know who we are
+        if (m_id > 0) {
+            SafeDataStream str(m_socket);
+            WireWriter hello(Msg::HELLO);
+            hello << m_id;
+            str.send(hello.data());
+            if (str.status() != QDataStream::Ok)
+                qCritical() << "Couldn't write initial message:" << str.status();
+        }
 
         if (!m_backend->start(m_user)) {
             authenticated(QString());
@@ -176,73 +248,79 @@ namespace SDDM {
 
     void HelperApp::info(const QString& message, Auth::Info type) {
         SafeDataStream str(m_socket);
-        str << Msg::INFO << message << type;
-        str.send();
+        WireWriter out(Msg::INFO);
+        out << message << type;
+        str.send(out.data());
         m_socket->waitForBytesWritten();
     }
 
     void HelperApp::error(const QString& message, Auth::Error type) {
         SafeDataStream str(m_socket);
-        str << Msg::ERROR << message << type;
-        str.send();
+        WireWriter out(Msg::ERROR);
+        out << message << type;
+        str.send(out.data());
         m_socket->waitForBytesWritten();
     }
 
     Request HelperApp::request(const Request& request) {
-        Msg m = Msg::MSG_UNKNOWN;
         Request response;
         SafeDataStream str(m_socket);
-        str << Msg::REQUEST << request;
-        str.send();
+        WireWriter out(Msg::REQUEST);
+        out << request;
+        str.send(out.data());
         str.receive();
-        str >> m >> response;
-        if (m != REQUEST) {
+        WireReader in(str.frame());
+        in >> response;
+        if (!in.isValid() || in.message() != REQUEST) {
             response = Request();
-            qCritical() << "Received a wrong opcode instead of REQUEST:" << m;
+            qCritical() << "Received a wrong opcode instead of REQUEST:" << in.message();
         }
         return response;
     }
 
     QProcessEnvironment HelperApp::authenticated(const QString &user) {
-        Msg m = Msg::MSG_UNKNOWN;
         QProcessEnvironment env;
         SafeDataStream str(m_socket);
-        str << Msg::AUTHENTICATED << user;
-        str.send();
+        WireWriter out(Msg::AUTHENTICATED);
+        out << user;
+        str.send(out.data());
         if (user.isEmpty())
             return env;
         str.receive();
-        str >> m >> env >> m_cookie;
-        if (m != AUTHENTICATED) {
+        WireReader in(str.frame());
+        // the daemon sends the difference to the environment it started us with
+        in.readEnvironment(env, m_startEnvironment);
+        in >> m_cookie;
+        if (!in.isValid() || in.message() != AUTHENTICATED) {
             env = QProcessEnvironment();
             m_cookie = QString();
-            qCritical() << "Received a wrong opcode instead of AUTHENTICATED:" << m;
+            qCritical() << "Received a wrong opcode instead of AUTHENTICATED:" << in.message();
         }
         return env;
     }
 
     void HelperApp::sessionOpened(bool success, qint64 pid) {
-        Msg m = Msg::MSG_UNKNOWN;
         SafeDataStream str(m_socket);
-        str << Msg::SESSION_STATUS << success << pid;
-        str.send();
+        WireWriter out(Msg::SESSION_STATUS);
+        out << success << pid;
+        str.send(out.data());
         str.receive();
-        str >> m;
-        if (m != SESSION_STATUS) {
-            qCritical() << "Received a wrong opcode instead of SESSION_STATUS:" << m;
+        WireReader in(str.frame());
+        if (!in.isValid() || in.message() != SESSION_STATUS) {
+            qCritical() << "Received a wrong opcode instead of SESSION_STATUS:" << in.message();
         }
     }
 
     void HelperApp::displayServerStarted(const QString &displayName)
     {
-        Msg m = Msg::MSG_UNKNOWN;
         SafeDataStream str(m_socket);
-        str << Msg::DISPLAY_SERVER_STARTED << displayName;
-        str.send();
+        WireWriter out(Msg::DISPLAY_SERVER_STARTED);
+        out << displayName;
+        str.send(out.data());
         str.receive();
-        str >> m;
-        if (m != DISPLAY_SERVER_STARTED) {
-            qCritical() << "Received a wrong opcode instead of DISPLAY_SERVER_STARTED:" << m;
+        WireReader in(str.frame());
+        if (!in.isValid() || in.message() != DISPLAY_SERVER_STARTED) {
+            qCritical() << "Received a wrong opcode instead of DISPLAY_SERVER_STARTED:" << in.message();
         }
     }
 
@@ -52,12 +52,17 @@ namespace SDDM {
 
     private slots:
         void setUp();
+        void startRequested();
         void doAuth();
 
         void sessionFinished(int status);
 
     private:
+        bool setUpSession(const QStringList &args);
+
         qint64 m_id { -1 };
+        // what the daemon started us with, before PAM modules touch it
+        QProcessEnvironment m_startEnvironment { QProcessEnvironment::systemEnvironment() };
         Backend *m_backend { nullptr };
         UserSession *m_session { nullptr };
         QLocalSocket *m_socket { nullptr };
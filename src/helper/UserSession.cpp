@@ -108,8 +108,12 @@ namespace SDDM {
         }
 
         if (m_process->waitForStarted()) {
-            int vtNumber = processEnvironment().value(QStringLiteral("XDG_VTNR")).toInt();
-            VirtualTerminal::jumpToVt(vtNumber, true);
+            // a standby greeter waits in the background until the daemon
+            // switches to it
+            if (env.value(QStringLiteral("SDDM_STANDBY")) != QLatin1String("1")) {
+                int vtNumber = processEnvironment().value(QStringLiteral("XDG_VTNR")).toInt();
+                VirtualTerminal::jumpToVt(vtNumber, true);
+            }
             return true;
         } else if (isWaylandGreeter) {
             // This is probably fine, we need the compositor to start first
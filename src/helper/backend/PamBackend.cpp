@@ -212,6 +212,13 @@ namespace SDDM {
         delete m_pam;
     }
 
+    void PamBackend::preload() {
+        // starting the transaction loads the modules of the service,
+        // guess the one regular logins use
+        if (m_pam->start(QStringLiteral("sddm")))
+            m_preloaded = QStringLiteral("sddm");
+    }
+
     bool PamBackend::start(const QString &user) {
         bool result;
 
@@ -221,7 +228,18 @@ namespace SDDM {
             service = QStringLiteral("sddm-greeter");
         else if (m_autologin)
             service = QStringLiteral("sddm-autologin");
-        result = m_pam->start(service, user);
+
+        if (m_preloaded == service) {
+            // the modules are loaded already, it only lacks the user
+            m_preloaded.clear();
+            result = user.isEmpty() || m_pam->setItem(PAM_USER, qPrintable(user));
+        } else {
+            if (!m_preloaded.isEmpty()) {
+                m_preloaded.clear();
+                m_pam->end();
+            }
+            result = m_pam->start(service, user);
+        }
 
         if (!result)
             m_app->error(m_pam->errorString(), Auth::ERROR_INTERNAL);
@@ -62,6 +62,8 @@ namespace SDDM {
         virtual ~PamBackend();
         int converse(int n, const struct pam_message **msg, struct pam_response **resp);
 
+        virtual void preload();
+
     public slots:
         virtual bool start(const QString &user = QString());
         virtual bool authenticate();
@@ -73,6 +75,7 @@ namespace SDDM {
     private:
         PamData *m_data { nullptr };
         PamHandle *m_pam { nullptr };
+        QString m_preloaded { };
     };
 }
 
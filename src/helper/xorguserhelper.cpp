@@ -22,6 +22,7 @@
 #include <QStandardPaths>
 
 #include "Configuration.h"
+#include "HookRunner.h"
 
 #include "xorguserhelper.h"
 
@@ -207,26 +208,16 @@ void XOrgUserHelper::startDisplayCommand()
     env.insert(QStringLiteral("DISPLAY"), m_display);
     env.insert(QStringLiteral("XAUTHORITY"), m_xauth.authPath());
 
-    // Set cursor
-    qInfo("Setting default cursor...");
-    QProcess *setCursor = nullptr;
-    if (startProcess(QStringLiteral("xsetroot -cursor_name left_ptr"), env, &setCursor)) {
-        if (!setCursor->waitForFinished(1000)) {
-            qWarning() << "Could not setup default cursor";
-            setCursor->kill();
-        }
-        setCursor->deleteLater();
-    }
-
-    // Display setup script
-    auto cmd = mainConfig.X11.DisplayCommand.get();
-    qInfo("Running display setup script: %s", qPrintable(cmd));
-    QProcess *displayScript = nullptr;
-    if (startProcess(cmd, env, &displayScript)) {
-        if (!displayScript->waitForFinished(30000))
-            displayScript->kill();
-        displayScript->deleteLater();
-    }
+    // This process only serves this display, so waiting for the
+    // blocking hooks here doesn't hold up anything else
+    auto *hooks = new HookRunner(this);
+    hooks->setProcessEnvironment(env);
+    hooks->add(QStringLiteral("Xsetup"), mainConfig.X11.DisplayCommand.get(),
+               mainConfig.X11.DisplayCommandTimeout.get() * 1000,
+               mainConfig.X11.DisplayCommandBlocking.get());
+    hooks->add(QStringLiteral("xsetroot"), QStringLiteral("xsetroot -cursor_name left_ptr"), 1000, false);
+    connect(hooks, &HookRunner::finished, hooks, &HookRunner::deleteLater);
+    hooks->waitForReady();
 }
 
 void XOrgUserHelper::displayFinished()
@@ -236,14 +227,12 @@ void XOrgUserHelper::displayFinished()
     env.insert(QStringLiteral("XAUTHORITY"), m_xauth.authPath());
     env.insert(QStringLiteral("QT_QPA_PLATFORM"), QStringLiteral("xcb"));
 
-    auto cmd = mainConfig.X11.DisplayStopCommand.get();
-    qInfo("Running display stop script: %s", qPrintable(cmd));
-    QProcess *displayStopScript = nullptr;
-    if (startProcess(cmd, env, &displayStopScript)) {
-        if (!displayStopScript->waitForFinished(5000))
-            displayStopScript->kill();
-        displayStopScript->deleteLater();
-    }
+    // The helper exits right after, let the script finish first
+    HookRunner hooks;
+    hooks.setProcessEnvironment(env);
+    hooks.add(QStringLiteral("Xstop"), mainConfig.X11.DisplayStopCommand.get(),
+              mainConfig.X11.DisplayStopCommandTimeout.get() * 1000);
+    hooks.waitForFinished();
 
     // Remove xauthority file
     QFile::remove(m_xauth.authPath());
@@ -0,0 +1,103 @@
+/*
+ * Auth wire format benchmarks
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+
+#include "AuthWireBenchmark.h"
+#include "AuthWire.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(AuthWireBenchmark);
+
+void AuthWireBenchmark::initTestCase() {
+    request.prompts << Prompt(AuthPrompt::LOGIN_USER, QStringLiteral("login:"), false)
+                    << Prompt(AuthPrompt::LOGIN_PASSWORD, QStringLiteral("Password: "), true)
+                    << Prompt(AuthPrompt::UNKNOWN, QStringLiteral("Enter the code from your token"), false);
+    request.prompts[0].response = "user";
+    request.prompts[1].response = "correct horse battery staple";
+
+    // what the helper gets started with, plus a large GreeterEnvironment
+    base = QProcessEnvironment::systemEnvironment();
+    base.insert(QStringLiteral("LANG"), QStringLiteral("en_US.UTF-8"));
+    environment = base;
+    for (int i = 0; i < 200; i++)
+        environment.insert(QStringLiteral("SDDM_BENCHMARK_VARIABLE_%1").arg(i), QStringLiteral("/usr/share/some/fairly/long/value/%1").arg(i));
+    environment.insert(QStringLiteral("PATH"), QStringLiteral("/usr/local/bin:/usr/bin:/bin"));
+
+    QByteArray stream;
+    QDataStream out(&stream, QIODevice::WriteOnly);
+    out << AUTHENTICATED << environment << QStringLiteral("cookie");
+    WireWriter wire(AUTHENTICATED);
+    wire.writeEnvironment(environment, base);
+    wire << QStringLiteral("cookie");
+    qDebug() << "AUTHENTICATED reply:" << stream.size() << "bytes with QDataStream," << wire.data().size() << "bytes on the wire";
+}
+
+void AuthWireBenchmark::RequestDataStream() {
+    QBENCHMARK {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << REQUEST << request;
+
+        QDataStream in(data);
+        Msg m = MSG_UNKNOWN;
+        Request r;
+        in >> m >> r;
+    }
+}
+
+void AuthWireBenchmark::RequestWire() {
+    QBENCHMARK {
+        WireWriter out(REQUEST);
+        out << request;
+
+        WireReader in(out.data());
+        Request r;
+        in >> r;
+    }
+}
+
+void AuthWireBenchmark::EnvironmentDataStream() {
+    QBENCHMARK {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << AUTHENTICATED << environment << QStringLiteral("cookie");
+
+        QDataStream in(data);
+        Msg m = MSG_UNKNOWN;
+        QProcessEnvironment env;
+        QString cookie;
+        in >> m >> env >> cookie;
+    }
+}
+
+void AuthWireBenchmark::EnvironmentWire() {
+    QBENCHMARK {
+        WireWriter out(AUTHENTICATED);
+        out.writeEnvironment(environment, base);
+        out << QStringLiteral("cookie");
+
+        WireReader in(out.data());
+        QProcessEnvironment env;
+        QString cookie;
+        in.readEnvironment(env, base);
+        in >> cookie;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Auth wire format benchmarks
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+
+#ifndef AUTHWIREBENCHMARK_H
+#define AUTHWIREBENCHMARK_H
+
+#include <QObject>
+#include <QProcessEnvironment>
+
+#include "AuthMessages.h"
+
+class AuthWireBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void RequestDataStream();
+    void RequestWire();
+    void EnvironmentDataStream();
+    void EnvironmentWire();
+
+private:
+    SDDM::Request request;
+    QProcessEnvironment base;
+    QProcessEnvironment environment;
+};
+
+#endif // AUTHWIREBENCHMARK_H
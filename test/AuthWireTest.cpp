@@ -0,0 +1,182 @@
+/*
+ * Auth wire format tests
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+
+#include "AuthWireTest.h"
+#include "AuthWire.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(AuthWireTest);
+
+#define FUZZ_ITERATIONS 2000
+
+static QString randomString() {
+    static const QString alphabet = QStringLiteral("abcXYZ019 =,;äß€中");
+    QString s;
+    const int length = qrand() % 24;
+    for (int i = 0; i < length; i++)
+        s.append(alphabet.at(qrand() % alphabet.size()));
+    return s;
+}
+
+static QByteArray randomBytes() {
+    QByteArray b;
+    const int length = qrand() % 24;
+    for (int i = 0; i < length; i++)
+        b.append(char(qrand()));
+    return b;
+}
+
+static Request randomRequest() {
+    static const AuthPrompt::Type types[] = { AuthPrompt::NONE, AuthPrompt::UNKNOWN, AuthPrompt::CHANGE_CURRENT, AuthPrompt::LOGIN_USER, AuthPrompt::LOGIN_PASSWORD };
+    Request r;
+    const int count = qrand() % 4;
+    for (int i = 0; i < count; i++) {
+        Prompt p(types[qrand() % 5], randomString(), qrand() % 2);
+        p.response = randomBytes();
+        r.prompts << p;
+    }
+    return r;
+}
+
+static QProcessEnvironment randomEnvironment() {
+    QProcessEnvironment env;
+    const int count = qrand() % 16;
+    for (int i = 0; i < count; i++)
+        env.insert(QStringLiteral("VAR%1").arg(qrand() % 32), randomString());
+    return env;
+}
+
+static QByteArray encodeAuthenticated(const QProcessEnvironment &env, const QProcessEnvironment &base, const QString &cookie) {
+    WireWriter out(AUTHENTICATED);
+    out.writeEnvironment(env, base);
+    out << cookie;
+    return out.data();
+}
+
+void AuthWireTest::initTestCase() {
+    // reproducible runs
+    qsrand(4242);
+}
+
+void AuthWireTest::RoundTrip() {
+    for (int i = 0; i < FUZZ_ITERATIONS; i++) {
+        const Request request = randomRequest();
+        const QString message = randomString();
+        const qint64 number = (qint64(qrand()) << 33) ^ qrand() ^ -qint64(qrand() % 2);
+        const bool flag = qrand() % 2;
+        QStringList list;
+        for (int j = qrand() % 5; j > 0; j--)
+            list << randomString();
+
+        WireWriter out(REQUEST);
+        out << request << message << number << flag << list << Auth::ERROR_INTERNAL;
+
+        WireReader in(out.data());
+        Request request2;
+        QString message2;
+        qint64 number2 = 0;
+        bool flag2 = !flag;
+        QStringList list2;
+        Auth::Error error = Auth::ERROR_NONE;
+        in >> request2 >> message2 >> number2 >> flag2 >> list2 >> error;
+
+        QVERIFY(in.isValid());
+        QVERIFY(in.atEnd());
+        QCOMPARE(in.message(), REQUEST);
+        QVERIFY(request2 == request);
+        QCOMPARE(message2, message);
+        QCOMPARE(number2, number);
+        QCOMPARE(flag2, flag);
+        QCOMPARE(list2, list);
+        QVERIFY(error == Auth::ERROR_INTERNAL);
+    }
+}
+
+void AuthWireTest::Environment() {
+    for (int i = 0; i < FUZZ_ITERATIONS; i++) {
+        const QProcessEnvironment base = randomEnvironment();
+        // sometimes close to the base, sometimes unrelated
+        QProcessEnvironment env = qrand() % 2 ? base : QProcessEnvironment();
+        env.insert(randomEnvironment());
+        if (!env.isEmpty() && qrand() % 2)
+            env.remove(env.keys().first());
+
+        WireReader in(encodeAuthenticated(env, base, QStringLiteral("cookie")));
+        QProcessEnvironment env2;
+        QString cookie;
+        in.readEnvironment(env2, base);
+        in >> cookie;
+
+        QVERIFY(in.isValid());
+        QVERIFY(in.atEnd());
+        QVERIFY(env2 == env);
+        QCOMPARE(cookie, QStringLiteral("cookie"));
+    }
+}
+
+void AuthWireTest::Truncated() {
+    for (int i = 0; i < FUZZ_ITERATIONS / 10; i++) {
+        const QProcessEnvironment base = randomEnvironment();
+        const QByteArray data = encodeAuthenticated(randomEnvironment(), base, randomString());
+
+        // every field is needed, so no prefix may decode
+        for (int length = 0; length < data.size(); length++) {
+            WireReader in(data.left(length));
+            QProcessEnvironment env;
+            QString cookie;
+            in.readEnvironment(env, base);
+            in >> cookie;
+            QVERIFY(!in.isValid());
+        }
+    }
+}
+
+void AuthWireTest::Mutated() {
+    for (int i = 0; i < FUZZ_ITERATIONS * 5; i++) {
+        WireWriter out(REQUEST);
+        out << randomRequest();
+        QByteArray data = out.data();
+        const int flips = 1 + qrand() % 4;
+        for (int j = 0; j < flips; j++)
+            data[qrand() % data.size()] = char(qrand());
+
+        // must neither crash nor hand out prompts from broken data
+        WireReader in(data);
+        Request request;
+        in >> request;
+        if (!in.isValid())
+            QVERIFY(request.prompts.isEmpty());
+    }
+}
+
+void AuthWireTest::Version() {
+    WireWriter out(HELLO);
+    out << qint64(1);
+    QByteArray data = out.data();
+    data[0] = char(AUTH_PROTOCOL_VERSION + 1);
+
+    WireReader in(data);
+    qint64 id = 0;
+    in >> id;
+    QVERIFY(!in.isValid());
+    QCOMPARE(id, qint64(0));
+}
@@ -0,0 +1,80 @@
+# Runs a QtTest benchmark and compares its results against a baseline.
+#
+# Expects BENCHMARK (the executable), BASELINE (results file) and
+# TOLERANCE (allowed slowdown factor). With RECORD set the results are
+# written to BASELINE instead. A missing baseline is an error, timings
+# depend on the machine so it has to be recorded there first.
+
+execute_process(COMMAND "${BENCHMARK}" -csv
+                RESULT_VARIABLE _result
+                OUTPUT_VARIABLE _output)
+if(NOT _result EQUAL 0)
+    message(FATAL_ERROR "${BENCHMARK} failed:\n${_output}")
+endif()
+
+# "function","tag","metric",value per iteration,total,iterations
+string(REGEX MATCHALL "\"[^\"\n]*\",\"[^\"\n]*\",\"[^\"\n]*\",[^,\n]+" _lines "${_output}")
+set(_results "")
+foreach(_line ${_lines})
+    string(REGEX REPLACE "^\"([^\"]*)\",\"([^\"]*)\",\"[^\"]*\",([^,]+)$" "\\1:\\2 \\3" _entry "${_line}")
+    string(REPLACE ": " " " _entry "${_entry}")
+    string(APPEND _results "${_entry}\n")
+endforeach()
+if(_results STREQUAL "")
+    message(FATAL_ERROR "No benchmark results in:\n${_output}")
+endif()
+
+if(RECORD)
+    file(WRITE "${BASELINE}" "${_results}")
+    message(STATUS "Recorded baseline ${BASELINE}:\n${_results}")
+    return()
+endif()
+
+file(WRITE "${BASELINE}.last" "${_results}")
+if(NOT EXISTS "${BASELINE}")
+    message(FATAL_ERROR "No baseline at ${BASELINE}, record one with the "
+                        "record-configuration-benchmark target on this machine. "
+                        "The results of this run are in ${BASELINE}.last:\n${_results}")
+endif()
+
+# CMake has no floating point math, so the milliseconds are compared as
+# integer nanoseconds. Anything printed in exponent notation is below that.
+function(to_nanoseconds _value _out)
+    if(_value MATCHES "e-")
+        set(${_out} 0 PARENT_SCOPE)
+        return()
+    endif()
+    if(NOT _value MATCHES "^([0-9]+)\\.?([0-9]*)$")
+        message(FATAL_ERROR "Unexpected benchmark value ${_value}")
+    endif()
+    set(_int ${CMAKE_MATCH_1})
+    string(SUBSTRING "${CMAKE_MATCH_2}000000" 0 6 _frac)
+    math(EXPR _ns "${_int} * 1000000 + 1${_frac} - 1000000")
+    set(${_out} ${_ns} PARENT_SCOPE)
+endfunction()
+
+file(STRINGS "${BASELINE}" _baseline)
+string(REPLACE "\n" ";" _current "${_results}")
+set(_failed "")
+foreach(_entry ${_current})
+    string(REGEX REPLACE " .*" "" _name "${_entry}")
+    string(REGEX REPLACE ".* " "" _value "${_entry}")
+    foreach(_base ${_baseline})
+        string(REGEX REPLACE " .*" "" _baseName "${_base}")
+        if(_baseName STREQUAL _name)
+            string(REGEX REPLACE ".* " "" _baseValue "${_base}")
+            to_nanoseconds("${_baseValue}" _limit)
+            to_nanoseconds("${_value}" _measured)
+            # don't fail on noise around a few hundred nanoseconds
+            math(EXPR _limit "${_limit} * ${TOLERANCE} + 1000")
+            if(_measured GREATER _limit)
+                string(APPEND _failed "  ${_name}: ${_value} ms (baseline ${_baseValue} ms)\n")
+            endif()
+        endif()
+    endforeach()
+endforeach()
+
+if(NOT _failed STREQUAL "")
+    message(FATAL_ERROR "Slower than ${TOLERANCE}x the baseline:\n${_failed}")
+endif()
+message(STATUS "Within ${TOLERANCE}x of ${BASELINE}:\n${_results}")
@@ -0,0 +1,154 @@
+/*
+ * Configuration parser benchmarks
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ConfigurationBenchmark.h"
+
+#include <QtTest/QtTest>
+#include <QtCore/QFile>
+#include <QtCore/QDir>
+
+QTEST_MAIN(ConfigurationBenchmark);
+
+static void writeDropIn(const QString &path, int n) {
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    for (const char *section : { "General", "First", "Second" }) {
+        file.write(QByteArray("[") + section + "]\n");
+        file.write(QByteArray("String=drop-in number ") + QByteArray::number(n) + " # comment\n");
+        file.write(QByteArray("Int=") + QByteArray::number(n * 1000) + "\n");
+        file.write("StringList=alpha, beta,gamma ,delta,epsilon\n");
+        file.write(n % 2 ? "Boolean=true\n" : "Boolean=False\n");
+        file.write(n % 3 ? "Mode=on\n" : "Mode=off\n");
+        file.write("Unknown=ignored\n");
+    }
+
+    // a different slice of the generated keys in every file
+    file.write("[Generated]\n");
+    for (int i = 0; i < BENCH_KEYS_PER_DROP_IN; i++) {
+        const int key = BENCH_KEYS_FIRST + (n * BENCH_KEYS_PER_DROP_IN + i) % BENCH_KEYS;
+        file.write("Key" + QByteArray::number(key) + "=value " + QByteArray::number(n) + "\n");
+    }
+}
+
+void ConfigurationBenchmark::initTestCase() {
+    QFile::remove(BENCH_CONF_FILE);
+    for (const QString &dir : { BENCH_CONF_DIR, BENCH_SYS_CONF_DIR }) {
+        QDir(dir).removeRecursively();
+        QDir().mkdir(dir);
+        for (int i = 0; i < BENCH_DROP_INS; i++)
+            writeDropIn(QStringLiteral("%1/%2.conf").arg(dir).arg(i, 4, 10, QLatin1Char('0')), i);
+    }
+    writeDropIn(BENCH_CONF_FILE, BENCH_DROP_INS);
+
+    config = new BenchConfig;
+    QCOMPARE(config->Int.get(), BENCH_DROP_INS * 1000);
+    QCOMPARE(config->Second.StringList.get().size(), 5);
+    QCOMPARE(config->First.Mode.get(), BenchConfig::MODE_ON);
+    QCOMPARE(config->Generated.entries().size(), BENCH_KEYS);
+    // the main file comes last
+    QCOMPARE(config->Generated.Key2000.get(), QStringLiteral("value %1").arg(BENCH_DROP_INS));
+}
+
+void ConfigurationBenchmark::cleanupTestCase() {
+    delete config;
+    config = nullptr;
+    QFile::remove(BENCH_CONF_FILE);
+    QDir(BENCH_CONF_DIR).removeRecursively();
+    QDir(BENCH_SYS_CONF_DIR).removeRecursively();
+}
+
+void ConfigurationBenchmark::LoadCold() {
+    QBENCHMARK {
+        BenchConfig cold;
+    }
+}
+
+void ConfigurationBenchmark::LoadWarm() {
+    // nothing changed, so this only checks the modification times
+    QBENCHMARK {
+        config->load();
+    }
+}
+
+void ConfigurationBenchmark::ParseDropIns() {
+    QBENCHMARK {
+        config->reload();
+    }
+}
+
+void ConfigurationBenchmark::ParseValues() {
+    const QString string = QStringLiteral(" some string value ");
+    const QString number = QStringLiteral("123456");
+    const QString list = QStringLiteral("alpha, beta,gamma ,delta,epsilon");
+    const QString boolean = QStringLiteral("true");
+    const QString mode = QStringLiteral("off");
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; i++) {
+            config->First.String.setValue(string);
+            config->First.Int.setValue(number);
+            config->First.StringList.setValue(list);
+            config->First.Boolean.setValue(boolean);
+            config->First.Mode.setValue(mode);
+        }
+    }
+}
+
+void ConfigurationBenchmark::FormatValues() {
+    QBENCHMARK {
+        for (int i = 0; i < 1000; i++) {
+            // changing the value invalidates the formatted text
+            config->Second.Int.set(i);
+            config->Second.Int.value();
+            config->Second.StringList.set(config->Second.StringList.get());
+            config->Second.StringList.value();
+            config->Second.Boolean.set(i % 2);
+            config->Second.Boolean.value();
+            config->Second.Mode.set(BenchConfig::MODE_OFF);
+            config->Second.Mode.value();
+        }
+    }
+}
+
+void ConfigurationBenchmark::Serialize() {
+    QBENCHMARK {
+        config->toConfigFull();
+    }
+}
+
+void ConfigurationBenchmark::SaveSingle() {
+    int i = 0;
+    QBENCHMARK {
+        config->Second.Int.set(++i);
+        config->Second.Int.save();
+    }
+}
+
+void ConfigurationBenchmark::SaveAll() {
+    int i = 0;
+    QBENCHMARK {
+        ++i;
+        for (SDDM::ConfigEntryBase *entry : config->First.entries())
+            entry->setValue(QString::number(i));
+        for (SDDM::ConfigEntryBase *entry : config->Generated.entries())
+            entry->setValue(QString::number(i));
+        config->save();
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Configuration parser benchmarks
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef CONFIGURATIONBENCHMARK_H
+#define CONFIGURATIONBENCHMARK_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "ConfigReader.h"
+
+#define BENCH_CONF_FILE QStringLiteral("bench.conf")
+#define BENCH_CONF_DIR QStringLiteral("benchconfdir")
+#define BENCH_SYS_CONF_DIR QStringLiteral("benchconfdir2")
+
+// number of drop-in files in each of the two directories
+#define BENCH_DROP_INS 200
+
+// distinct generated keys, Key1000 to Key3999 in the Generated section,
+// and how many of them each drop-in sets
+#define BENCH_KEYS 3000
+#define BENCH_KEYS_FIRST 1000
+#define BENCH_KEYS_PER_DROP_IN 50
+
+#define BENCH_ENTRY(n) Entry(Key##n, QString, QString(), _S("Generated key"));
+#define BENCH_ENTRIES_10(p) \
+    BENCH_ENTRY(p##0) BENCH_ENTRY(p##1) BENCH_ENTRY(p##2) BENCH_ENTRY(p##3) BENCH_ENTRY(p##4) \
+    BENCH_ENTRY(p##5) BENCH_ENTRY(p##6) BENCH_ENTRY(p##7) BENCH_ENTRY(p##8) BENCH_ENTRY(p##9)
+#define BENCH_ENTRIES_100(p) \
+    BENCH_ENTRIES_10(p##0) BENCH_ENTRIES_10(p##1) BENCH_ENTRIES_10(p##2) BENCH_ENTRIES_10(p##3) BENCH_ENTRIES_10(p##4) \
+    BENCH_ENTRIES_10(p##5) BENCH_ENTRIES_10(p##6) BENCH_ENTRIES_10(p##7) BENCH_ENTRIES_10(p##8) BENCH_ENTRIES_10(p##9)
+#define BENCH_ENTRIES_1000(p) \
+    BENCH_ENTRIES_100(p##0) BENCH_ENTRIES_100(p##1) BENCH_ENTRIES_100(p##2) BENCH_ENTRIES_100(p##3) BENCH_ENTRIES_100(p##4) \
+    BENCH_ENTRIES_100(p##5) BENCH_ENTRIES_100(p##6) BENCH_ENTRIES_100(p##7) BENCH_ENTRIES_100(p##8) BENCH_ENTRIES_100(p##9)
+
+Config (BenchConfig, BENCH_CONF_FILE, BENCH_CONF_DIR, BENCH_SYS_CONF_DIR,
+    enum Switch {
+        MODE_NONE,
+        MODE_ON,
+        MODE_OFF
+    };
+    Entry(    String,         QString,                  QString(), _S("String"));
+    Entry(       Int,             int,                          0, _S("Integer"));
+    Entry(StringList,     QStringList,              QStringList(), _S("StringList"));
+    Entry(   Boolean,            bool,                      false, _S("Boolean"));
+    Entry(      Mode,            Switch,                MODE_NONE, _S("Enumeration"));
+    Section(First,
+        Entry(    String,         QString,                  QString(), _S("String"));
+        Entry(       Int,             int,                          0, _S("Integer"));
+        Entry(StringList,     QStringList,              QStringList(), _S("StringList"));
+        Entry(   Boolean,            bool,                      false, _S("Boolean"));
+        Entry(      Mode,            Switch,                MODE_NONE, _S("Enumeration"));
+    );
+    Section(Second,
+        Entry(    String,         QString,                  QString(), _S("String"));
+        Entry(       Int,             int,                          0, _S("Integer"));
+        Entry(StringList,     QStringList,              QStringList(), _S("StringList"));
+        Entry(   Boolean,            bool,                      false, _S("Boolean"));
+        Entry(      Mode,            Switch,                MODE_NONE, _S("Enumeration"));
+    );
+    Section(Generated,
+        BENCH_ENTRIES_1000(1)
+        BENCH_ENTRIES_1000(2)
+        BENCH_ENTRIES_1000(3)
+    );
+);
+
+inline SDDM::ConfigEnumValues<BenchConfig::Switch> configEnumValues(BenchConfig::Switch) {
+    static const SDDM::ConfigEnumValue<BenchConfig::Switch> values[] = {
+        { "none", BenchConfig::MODE_NONE },
+        { "on",   BenchConfig::MODE_ON },
+        { "off",  BenchConfig::MODE_OFF },
+    };
+    return { std::begin(values), std::end(values) };
+}
+
+class ConfigurationBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void LoadCold();
+    void LoadWarm();
+    void ParseDropIns();
+    void ParseValues();
+    void FormatValues();
+    void Serialize();
+    // these rewrite BENCH_CONF_FILE and have to come last
+    void SaveSingle();
+    void SaveAll();
+
+private:
+    BenchConfig *config { nullptr };
+};
+
+#endif // CONFIGURATIONBENCHMARK_H
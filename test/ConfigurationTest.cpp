@@ -25,6 +25,11 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
 QTEST_MAIN(ConfigurationTest);
 
 void ConfigurationTest::initTestCase() { }
@@ -38,6 +43,8 @@ void ConfigurationTest::init() {
     QDir(SYS_CONF_DIR).removeRecursively();
     QDir().mkdir(SYS_CONF_DIR);
     QFile::remove(CONF_FILE_COPY);
+    QFile::remove(CONF_SNAPSHOT);
+    QFile::remove(CONF_JOURNAL);
     config = new TestConfig;
 }
 
@@ -46,6 +53,8 @@ void ConfigurationTest::cleanup() {
     QDir(CONF_DIR).removeRecursively();
     QDir(SYS_CONF_DIR).removeRecursively();
     QFile::remove(CONF_FILE_COPY);
+    QFile::remove(CONF_SNAPSHOT);
+    QFile::remove(CONF_JOURNAL);
     if (config)
         delete config;
     config = nullptr;
@@ -142,6 +151,30 @@ void ConfigurationTest::CustomEnum() {
     QVERIFY(!contents.contains("foo"));
 }
 
+void ConfigurationTest::IntValues() {
+    const QList<QPair<QString, int>> values {
+        { QStringLiteral("42"), 42 },
+        { QStringLiteral(" -42 "), -42 },
+        { QStringLiteral("+7"), 7 },
+        { QStringLiteral("0x1F"), 31 },
+        { QStringLiteral("0b101"), 5 },
+        { QStringLiteral("010"), 8 },
+        { QStringLiteral("0"), 0 },
+        { QStringLiteral("-2147483648"), std::numeric_limits<int>::min() },
+        { QStringLiteral("99999999999"), std::numeric_limits<int>::max() },
+        { QStringLiteral("-99999999999"), std::numeric_limits<int>::min() },
+        // the leading number, like QTextStream did
+        { QStringLiteral("123abc"), 123 },
+        { QStringLiteral("1000 # comment"), 1000 },
+        { QStringLiteral("abc"), 0 },
+        { QString(), 0 },
+    };
+    for (const auto &value : values) {
+        config->Int.setValue(value.first);
+        QCOMPARE(config->Int.get(), value.second);
+    }
+}
+
 void ConfigurationTest::RightOnInit() {
     delete config;
     QFile confFile(CONF_FILE);
@@ -244,4 +277,223 @@ void ConfigurationTest::FileChanged()
     QVERIFY(config->Int.get() == 222222);
 }
 
+void ConfigurationTest::SnapshotReuse()
+{
+    QFile confFileA(CONF_DIR+QStringLiteral("/0001A"));
+    confFileA.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFileA.write("String=a\n");
+    confFileA.write("[Section]\n");
+    confFileA.write("StringList=a,b\n");
+    confFileA.close();
+
+    QFile confFileMain(CONF_FILE);
+    confFileMain.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFileMain.write("String=b\n");
+    confFileMain.write("Int=99999\n");
+    confFileMain.close();
+
+    // the first instance parses the files and stores the result
+    QScopedPointer<SnapshotTestConfig> first(new SnapshotTestConfig);
+    QVERIFY(QFile::exists(CONF_SNAPSHOT));
+    QVERIFY(first->String.get() == QStringLiteral("b"));
+
+    // change the main file behind the snapshot's back, same inode, size
+    // and modification time, so the second one can only see the old
+    // value if it comes from the snapshot
+    struct stat before;
+    QVERIFY(::stat(qPrintable(CONF_FILE), &before) == 0);
+    confFileMain.open(QIODevice::ReadWrite);
+    confFileMain.write("String=c\n");
+    confFileMain.close();
+    const struct timespec times[2] = { before.st_atim, before.st_mtim };
+    QVERIFY(::utimensat(AT_FDCWD, qPrintable(CONF_FILE), times, 0) == 0);
+    struct stat after;
+    QVERIFY(::stat(qPrintable(CONF_FILE), &after) == 0);
+    QCOMPARE(after.st_ino, before.st_ino);
+    QCOMPARE(after.st_size, before.st_size);
+
+    QScopedPointer<SnapshotTestConfig> second(new SnapshotTestConfig);
+    QVERIFY(second->String.get() == QStringLiteral("b"));
+    QVERIFY(second->Int.get() == 99999);
+    QVERIFY(second->Section.StringList.get() == QStringList({QStringLiteral("a"), QStringLiteral("b")}));
+
+    // any modified input invalidates the snapshot
+    confFileA.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFileA.write("[Section]\n");
+    confFileA.write("StringList=c\n");
+    confFileA.close();
+
+    QScopedPointer<SnapshotTestConfig> third(new SnapshotTestConfig);
+    QVERIFY(third->String.get() == QStringLiteral("c"));
+    QVERIFY(third->Section.StringList.get() == QStringList({QStringLiteral("c")}));
+}
+
+void ConfigurationTest::Reload() {
+    QFile confFile(CONF_FILE);
+    confFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFile.write("String=a\n");
+    confFile.write("Int=5\n");
+    confFile.close();
+
+    QVERIFY(config->reload());
+    QCOMPARE(config->String.get(), QStringLiteral("a"));
+    QCOMPARE(config->Int.get(), 5);
+
+    // nothing changed
+    QVERIFY(!config->reload());
+
+    // entries that are gone are back to their defaults
+    QFile confFileA(CONF_DIR+QStringLiteral("/0001A"));
+    confFileA.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFileA.write("[Section]\n");
+    confFileA.write("Boolean=false\n");
+    confFileA.close();
+    confFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFile.write("String=a\n");
+    confFile.close();
+
+    QVERIFY(config->reload());
+    QCOMPARE(config->String.get(), QStringLiteral("a"));
+    QCOMPARE(config->Int.get(), TEST_INT_1);
+    QVERIFY(config->Int.isDefault());
+    QCOMPARE(config->Section.Boolean.get(), false);
+
+    QVERIFY(QFile::remove(CONF_DIR+QStringLiteral("/0001A")));
+    QVERIFY(config->reload());
+    QCOMPARE(config->Section.Boolean.get(), TEST_BOOL_1);
+}
+
+void ConfigurationTest::OnChanged() {
+    QScopedPointer<QObject> context(new QObject);
+    QStringList strings;
+    QList<int> ints;
+    config->String.onChanged(context.data(), [&strings](const QString &value) { strings << value; });
+    config->Int.onChanged(context.data(), [&ints](int value) { ints << value; });
+
+    QFile confFile(CONF_FILE);
+    confFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFile.write("String=a\n");
+    confFile.close();
+
+    // only the entries that changed are notified, once per reload
+    QVERIFY(config->reload());
+    QCOMPARE(strings, QStringList({QStringLiteral("a")}));
+    QVERIFY(ints.isEmpty());
+    QVERIFY(!config->reload());
+    QCOMPARE(strings.size(), 1);
+
+    confFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFile.write("Int=7\n");
+    confFile.close();
+
+    QVERIFY(config->reload());
+    QCOMPARE(strings, QStringList({QStringLiteral("a"), TEST_STRING_1}));
+    QCOMPARE(ints, QList<int>({7}));
+
+    // a handler may register another one for the same entry
+    int nested = 0;
+    config->Int.onChanged(context.data(), [this, &context, &nested](int) {
+        config->Int.onChanged(context.data(), [&nested](int) { nested++; });
+    });
+    confFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFile.write("Int=8\n");
+    confFile.close();
+    QVERIFY(config->reload());
+    QCOMPARE(ints, QList<int>({7, 8}));
+    QCOMPARE(nested, 0);
+
+    // handlers go away with their context
+    context.reset();
+    confFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFile.write("String=b\nInt=9\n");
+    confFile.close();
+    QVERIFY(config->reload());
+    QCOMPARE(strings.size(), 2);
+    QCOMPARE(ints.size(), 2);
+    QCOMPARE(nested, 0);
+}
+
+void ConfigurationTest::Schema() {
+    const SDDM::ConfigSchema &schema = TestConfig::schema();
+    const QString general = QStringLiteral(IMPLICIT_SECTION);
+    const QString section = QStringLiteral("Section");
+    const QString name = QStringLiteral("StringList");
+    const QString unknown = QStringLiteral("Unknown");
+
+    const int generalId = schema.sectionId(QStringRef(&general));
+    const int sectionId = schema.sectionId(QStringRef(&section));
+    QVERIFY(generalId >= 0);
+    QVERIFY(sectionId >= 0);
+    QVERIFY(schema.sectionId(QStringRef(&unknown)) < 0);
+
+    const int id = schema.entryId(sectionId, QStringRef(&name));
+    QVERIFY(id >= 0);
+    QVERIFY(id != schema.entryId(generalId, QStringRef(&name)));
+    QVERIFY(schema.entryId(sectionId, QStringRef(&unknown)) < 0);
+    QCOMPARE(schema.entries().at(id).section, sectionId);
+    QVERIFY(schema.entries().at(id).type == SDDM::ConfigType::StringList);
+    QCOMPARE(schema.entries().at(id).defaultValue, QStringLiteral("String1,String2"));
+
+    // the example configuration doesn't depend on what has been loaded
+    config->String.set(QStringLiteral("Changed String"));
+    QVERIFY(schema.toConfigFull() != config->toConfigFull());
+    config->wipe();
+    QCOMPARE(schema.toConfigFull(), config->toConfigFull());
+}
+
+void ConfigurationTest::JournalReplay() {
+    JournalTestConfig *journaled = new JournalTestConfig;
+    journaled->String.set(QStringLiteral("Journaled"));
+    journaled->save();
+    journaled->Section.Int.set(1);
+    journaled->save();
+    journaled->flush();
+    delete journaled;
+
+    // nothing but the journal has been written
+    QVERIFY(!QFile::exists(CONF_FILE));
+    QVERIFY(QFile::exists(CONF_JOURNAL));
+
+    journaled = new JournalTestConfig;
+    QCOMPARE(journaled->String.get(), QStringLiteral("Journaled"));
+    QCOMPARE(journaled->Section.Int.get(), 1);
+
+    // a torn record at the end is ignored
+    QFile journal(CONF_JOURNAL);
+    QVERIFY(journal.open(QIODevice::WriteOnly | QIODevice::Append));
+    journal.write("[General]\nString=Torn");
+    journal.close();
+    delete journaled;
+    journaled = new JournalTestConfig;
+    QCOMPARE(journaled->String.get(), QStringLiteral("Journaled"));
+
+    // a growing journal is folded back into the configuration file,
+    // keeping whatever else is in there
+    QFile confFile(CONF_FILE);
+    QVERIFY(confFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    confFile.write("# kept comment\n[Section]\nInt=5 # inline comment\nUnknown=kept\n\n[Other]\nKey=kept\n");
+    confFile.close();
+    for (int i = 0; i < 1000; i++) {
+        journaled->Section.Int.set(i);
+        journaled->save();
+    }
+    journaled->flush();
+    delete journaled;
+    QVERIFY(QFileInfo(CONF_JOURNAL).size() <= 4096);
+
+    QVERIFY(confFile.open(QIODevice::ReadOnly));
+    const QByteArray compacted = confFile.readAll();
+    confFile.close();
+    QVERIFY(compacted.contains("# kept comment\n"));
+    QVERIFY(compacted.contains("String=Journaled\n"));
+    QVERIFY(compacted.contains("# inline comment\n"));
+    QVERIFY(compacted.contains("Unknown=kept\n"));
+    QVERIFY(compacted.contains("[Other]\nKey=kept\n"));
+
+    journaled = new JournalTestConfig;
+    QCOMPARE(journaled->String.get(), QStringLiteral("Journaled"));
+    QCOMPARE(journaled->Section.Int.get(), 999);
+    delete journaled;
+}
+
 #include "moc_ConfigurationTest.cpp"
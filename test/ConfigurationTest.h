@@ -30,6 +30,8 @@
 #define CONF_DIR QStringLiteral("testconfdir")
 #define SYS_CONF_DIR QStringLiteral("testconfdir2")
 #define CONF_FILE_COPY QStringLiteral("test_copy.conf")
+#define CONF_SNAPSHOT QStringLiteral("test.conf.snapshot")
+#define CONF_JOURNAL QStringLiteral("test.conf.journal")
 
 #define TEST_STRING_1_PLAIN "Test Variable Initial String"
 #define TEST_STRING_1 QStringLiteral(TEST_STRING_1_PLAIN)
@@ -56,6 +58,23 @@ Config (TestConfig, CONF_FILE, CONF_DIR, SYS_CONF_DIR,
     );
 );
 
+Config (SnapshotTestConfig, CONF_FILE, CONF_DIR, SYS_CONF_DIR,
+    Snapshot(CONF_SNAPSHOT)
+    Entry(    String,         QString,         _S(TEST_STRING_1_PLAIN), _S("Test String Description"));
+    Entry(       Int,             int,                      TEST_INT_1, _S("Test Integer Description"));
+    Section(Section,
+        Entry(StringList,     QStringList,  QStringList(TEST_STRINGLIST_1), _S("Test StringList Description"));
+    );
+);
+
+Config (JournalTestConfig, CONF_FILE, QString(), QString(),
+    Journal()
+    Entry(    String,         QString,         _S(TEST_STRING_1_PLAIN), _S("Test String Description"));
+    Section(Section,
+        Entry(       Int,             int,                      TEST_INT_1, _S("Test Integer Description"));
+    );
+);
+
 inline QTextStream& operator>>(QTextStream &str, TestConfig::CustomType &state) {
     QString text = str.readLine().trimmed();
     if (text.compare(QLatin1String("foo"), Qt::CaseInsensitive) == 0)
@@ -92,9 +111,15 @@ private slots:
     void Unused();
     void LineChanges();
     void CustomEnum();
+    void IntValues();
     void RightOnInit();
     void RightOnInitDir();
     void FileChanged();
+    void SnapshotReuse();
+    void Reload();
+    void OnChanged();
+    void Schema();
+    void JournalReplay();
 
 private:
     TestConfig *config;
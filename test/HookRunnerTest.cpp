@@ -0,0 +1,97 @@
+/*
+ * Hook runner tests
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "HookRunnerTest.h"
+#include "HookRunner.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(HookRunnerTest);
+
+void HookRunnerTest::Order() {
+    HookRunner hooks;
+    QSignalSpy done(&hooks, &HookRunner::hookFinished);
+    QSignalSpy ready(&hooks, &HookRunner::ready);
+    hooks.add(QStringLiteral("first"), QStringLiteral("/bin/sh -c \"echo first\""), 5000);
+    hooks.add(QStringLiteral("second"), QStringLiteral("/bin/sh -c \"exit 3\""), 5000);
+    QVERIFY(!hooks.isReady());
+
+    hooks.waitForFinished();
+    QCOMPARE(done.count(), 2);
+    QCOMPARE(done.at(0).at(0).toString(), QStringLiteral("first"));
+    QCOMPARE(done.at(0).at(1).toBool(), true);
+    QCOMPARE(done.at(1).at(0).toString(), QStringLiteral("second"));
+    QCOMPARE(done.at(1).at(1).toBool(), false);
+    QCOMPARE(ready.count(), 1);
+    QVERIFY(hooks.isReady());
+}
+
+void HookRunnerTest::NonBlocking() {
+    HookRunner hooks;
+    QSignalSpy finished(&hooks, &HookRunner::finished);
+    hooks.add(QStringLiteral("quick"), QStringLiteral("/bin/sh -c \"exit 0\""), 5000);
+    hooks.add(QStringLiteral("slow"), QStringLiteral("sleep 1"), 5000, false);
+
+    // the slow one isn't waited for
+    hooks.waitForReady();
+    QVERIFY(hooks.isReady());
+    QVERIFY(!hooks.isFinished());
+    QCOMPARE(finished.count(), 0);
+
+    hooks.waitForFinished();
+    QCOMPARE(finished.count(), 1);
+}
+
+void HookRunnerTest::Timeout() {
+    HookRunner hooks;
+    QSignalSpy done(&hooks, &HookRunner::hookFinished);
+    QElapsedTimer timer;
+    timer.start();
+    hooks.add(QStringLiteral("hang"), QStringLiteral("sleep 30"), 200);
+
+    hooks.waitForFinished();
+    QVERIFY(timer.elapsed() < 10000);
+    QCOMPARE(done.count(), 1);
+    QCOMPARE(done.at(0).at(1).toBool(), false);
+}
+
+void HookRunnerTest::Missing() {
+    HookRunner hooks;
+    QSignalSpy done(&hooks, &HookRunner::hookFinished);
+    hooks.add(QStringLiteral("missing"), QStringLiteral("/nonexistent/hook"), 5000);
+    hooks.add(QStringLiteral("next"), QStringLiteral("/bin/sh -c \"exit 0\""), 5000);
+
+    // a broken hook doesn't stop the ones after it
+    hooks.waitForFinished();
+    QCOMPARE(done.count(), 2);
+    QCOMPARE(done.at(0).at(1).toBool(), false);
+    QCOMPARE(done.at(1).at(1).toBool(), true);
+}
+
+void HookRunnerTest::Empty() {
+    HookRunner hooks;
+    QSignalSpy finished(&hooks, &HookRunner::finished);
+    hooks.add(QStringLiteral("unset"), QString(), 5000);
+    QVERIFY(hooks.isReady());
+
+    QVERIFY(finished.wait(1000));
+}
@@ -0,0 +1,113 @@
+/*
+ * User index tests
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "UserIndexTest.h"
+#include "UserIndex.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(UserIndexTest);
+
+static UserEntry user(const QString &name, quint32 uid) {
+    UserEntry entry;
+    entry.name = name;
+    entry.realName = name.toUpper() + QStringLiteral(" Ünïcødé");
+    entry.homeDir = QStringLiteral("/home/") + name;
+    entry.uid = uid;
+    entry.gid = uid + 1;
+    entry.needsPassword = uid % 2;
+    if (uid % 3 == 0)
+        entry.icon = QStringLiteral("/usr/share/sddm/faces/%1.face.icon").arg(name);
+    return entry;
+}
+
+static UserEntryList users(int count) {
+    UserEntryList list;
+    for (int i = 0; i < count; i++)
+        list << user(QStringLiteral("user%1").arg(i, 5, 10, QLatin1Char('0')), quint32(1000 + i));
+    return list;
+}
+
+QString UserIndexTest::indexPath() const {
+    return m_dir.path() + QStringLiteral("/users.index");
+}
+
+void UserIndexTest::RoundTrip() {
+    const UserEntryList written = users(1000);
+    QVERIFY(UserIndex::write(indexPath(), written));
+
+    UserEntryList read;
+    QVERIFY(UserIndex::read(indexPath(), read));
+    QVERIFY(read == written);
+}
+
+void UserIndexTest::Empty() {
+    QVERIFY(UserIndex::write(indexPath(), UserEntryList()));
+
+    UserEntryList read = users(1);
+    QVERIFY(UserIndex::read(indexPath(), read));
+    QVERIFY(read.isEmpty());
+}
+
+void UserIndexTest::Truncated() {
+    QVERIFY(UserIndex::write(indexPath(), users(10)));
+
+    QFile file(indexPath());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 2));
+    file.close();
+
+    UserEntryList read;
+    QVERIFY(!UserIndex::read(indexPath(), read));
+    QVERIFY(read.isEmpty());
+}
+
+void UserIndexTest::Version() {
+    QVERIFY(UserIndex::write(indexPath(), users(10)));
+
+    QFile file(indexPath());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    // the version follows the magic number
+    QVERIFY(file.seek(4));
+    const quint32 version = 0xffff;
+    file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    file.close();
+
+    UserEntryList read;
+    QVERIFY(!UserIndex::read(indexPath(), read));
+}
+
+void UserIndexTest::Limit() {
+    UserEntryList list = users(100);
+    QVERIFY(!limitUsers(list, 8, QStringLiteral("user00050")));
+    QCOMPARE(list.size(), 9);
+    QCOMPARE(list.last().name, QStringLiteral("user00050"));
+
+    // already in the first ones
+    list = users(100);
+    QVERIFY(!limitUsers(list, 8, QStringLiteral("user00003")));
+    QCOMPARE(list.size(), 8);
+
+    list = users(5);
+    QVERIFY(limitUsers(list, 8, QStringLiteral("user00003")));
+    QCOMPARE(list.size(), 5);
+}
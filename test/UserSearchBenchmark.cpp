@@ -0,0 +1,69 @@
+/*
+ * User search benchmark
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "UserSearchBenchmark.h"
+#include "UserModel.h"
+#include "UserSearchModel.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(UserSearchBenchmark);
+
+static UserEntryList users(int count) {
+    UserEntryList list;
+    for (int i = 0; i < count; i++) {
+        UserEntry entry;
+        entry.name = QStringLiteral("user%1").arg(i, 6, 10, QLatin1Char('0'));
+        entry.realName = QStringLiteral("First%1 Last%2").arg(i % 1000).arg(i / 1000);
+        entry.homeDir = QStringLiteral("/home/") + entry.name;
+        entry.uid = quint32(1000 + i);
+        entry.gid = entry.uid;
+        list << entry;
+    }
+    return list;
+}
+
+void UserSearchBenchmark::Find_data() {
+    QTest::addColumn<QStringList>("typed");
+
+    QTest::newRow("name") << QStringList({ QStringLiteral("u"), QStringLiteral("us"), QStringLiteral("use"),
+                                           QStringLiteral("user"), QStringLiteral("user0"), QStringLiteral("user04"),
+                                           QStringLiteral("user042") });
+    QTest::newRow("real name") << QStringList({ QStringLiteral("f"), QStringLiteral("fi"), QStringLiteral("first"),
+                                                QStringLiteral("first4"), QStringLiteral("first42") });
+}
+
+void UserSearchBenchmark::Find() {
+    QFETCH(QStringList, typed);
+
+    // typing a name into the search of a greeter with 100k users, every
+    // character should take well under a millisecond
+    UserModel userModel(true);
+    UserSearchModel model(&userModel);
+    model.setUsers(users(100000));
+
+    QBENCHMARK {
+        for (const QString &query : qAsConst(typed))
+            model.setQuery(query);
+        model.setQuery(QString());
+    }
+}
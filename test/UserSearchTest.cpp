@@ -0,0 +1,167 @@
+/*
+ * User search tests
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "UserSearchTest.h"
+#include "UserModel.h"
+#include "UserPrefixIndex.h"
+#include "UserSearchModel.h"
+
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+using namespace SDDM;
+
+QTEST_MAIN(UserSearchTest);
+
+static UserEntry user(const QString &name, const QString &realName, quint32 uid = 1000) {
+    UserEntry entry;
+    entry.name = name;
+    entry.realName = realName;
+    entry.homeDir = QStringLiteral("/home/") + name;
+    entry.uid = uid;
+    entry.gid = uid;
+    return entry;
+}
+
+static UserEntryList users(int count) {
+    UserEntryList list;
+    for (int i = 0; i < count; i++) {
+        const QString name = QStringLiteral("user%1").arg(i, 6, 10, QLatin1Char('0'));
+        list << user(name, QStringLiteral("First%1 Last%2").arg(i % 1000).arg(i / 1000), quint32(1000 + i));
+    }
+    return list;
+}
+
+// the names of the users with keys in range, in key order
+static QStringList names(const UserPrefixIndex &index, const UserPrefixIndex::Range &range) {
+    QStringList list;
+    for (int key = range.begin; key < range.end; ++key)
+        list << index.user(index.userAt(key)).name;
+    return list;
+}
+
+static QStringList names(const UserSearchModel &model) {
+    QStringList list;
+    for (int row = 0; row < model.rowCount(); ++row)
+        list << model.data(model.index(row), UserModel::NameRole).toString();
+    return list;
+}
+
+void UserSearchTest::Narrowing() {
+    UserPrefixIndex index;
+    index.setUsers({ user(QStringLiteral("alan"), QString()),
+                     user(QStringLiteral("alice"), QString()),
+                     user(QStringLiteral("bob"), QString()) });
+
+    const UserPrefixIndex::Range a = index.find(QStringLiteral("a"), index.all());
+    QCOMPARE(names(index, a), QStringList({ QStringLiteral("alan"), QStringLiteral("alice") }));
+
+    // narrowing gives the same as searching everything again
+    const UserPrefixIndex::Range ali = index.find(QStringLiteral("ali"), a);
+    QCOMPARE(names(index, ali), QStringList({ QStringLiteral("alice") }));
+    QCOMPARE(names(index, ali), names(index, index.find(QStringLiteral("ali"), index.all())));
+
+    QVERIFY(index.find(QStringLiteral("alx"), ali).isEmpty());
+    QVERIFY(index.find(QStringLiteral("c"), index.all()).isEmpty());
+}
+
+void UserSearchTest::RealName() {
+    UserPrefixIndex index;
+    index.setUsers({ user(QStringLiteral("jdoe"), QStringLiteral("John Doe")),
+                     user(QStringLiteral("msmith"), QStringLiteral("Mary  Smith")) });
+
+    QCOMPARE(names(index, index.find(QStringLiteral("doe"), index.all())), QStringList({ QStringLiteral("jdoe") }));
+    QCOMPARE(names(index, index.find(QStringLiteral("SMI"), index.all())), QStringList({ QStringLiteral("msmith") }));
+    QCOMPARE(names(index, index.find(QStringLiteral("Jo"), index.all())), QStringList({ QStringLiteral("jdoe") }));
+
+    // only at the start of a word
+    QVERIFY(index.find(QStringLiteral("oe"), index.all()).isEmpty());
+}
+
+void UserSearchTest::Duplicates() {
+    UserModel userModel(true);
+    UserSearchModel model(&userModel);
+    model.setUsers({ user(QStringLiteral("anna"), QStringLiteral("Anna Andrews")),
+                     user(QStringLiteral("bert"), QStringLiteral("Bert Anderson")) });
+
+    // anna matches with her name and her last name, bert with his
+    model.setQuery(QStringLiteral("an"));
+    QCOMPARE(model.rowCount(), 2);
+    QStringList found = names(model);
+    std::sort(found.begin(), found.end());
+    QCOMPARE(found, QStringList({ QStringLiteral("anna"), QStringLiteral("bert") }));
+
+    model.setQuery(QStringLiteral("and"));
+    found = names(model);
+    std::sort(found.begin(), found.end());
+    QCOMPARE(found, QStringList({ QStringLiteral("anna"), QStringLiteral("bert") }));
+}
+
+void UserSearchTest::AddRemove() {
+    UserPrefixIndex index;
+    index.setUsers({ user(QStringLiteral("alice"), QString()),
+                     user(QStringLiteral("bob"), QString()) });
+
+    const UserPrefixIndex::Range bob = index.find(QStringLiteral("bob"), index.all());
+    QCOMPARE(bob.end - bob.begin, 1);
+    const int bobId = index.userAt(bob.begin);
+
+    // a changed entry keeps its id, a new one gets the next
+    index.addUsers({ user(QStringLiteral("carol"), QString()),
+                     user(QStringLiteral("bob"), QStringLiteral("Robert")) });
+    const UserPrefixIndex::Range robert = index.find(QStringLiteral("rob"), index.all());
+    QCOMPARE(robert.end - robert.begin, 1);
+    QCOMPARE(index.userAt(robert.begin), bobId);
+    QCOMPARE(index.user(bobId).realName, QStringLiteral("Robert"));
+    QCOMPARE(names(index, index.find(QStringLiteral("bob"), index.all())), QStringList({ QStringLiteral("bob") }));
+    QCOMPARE(names(index, index.find(QStringLiteral("car"), index.all())), QStringList({ QStringLiteral("carol") }));
+
+    // removed users can't be found, the others keep their ids
+    index.removeUsers({ QStringLiteral("alice") });
+    QVERIFY(index.find(QStringLiteral("alice"), index.all()).isEmpty());
+    QCOMPARE(index.userAt(index.find(QStringLiteral("bob"), index.all()).begin), bobId);
+    QCOMPARE(index.all().end, 3);
+
+    // and can come back
+    index.addUsers({ user(QStringLiteral("alice"), QString()) });
+    QCOMPARE(names(index, index.find(QStringLiteral("a"), index.all())), QStringList({ QStringLiteral("alice") }));
+}
+
+void UserSearchTest::Pages() {
+    UserModel userModel(true);
+    UserSearchModel model(&userModel);
+    model.setPageSize(50);
+    model.setUsers(users(1000));
+
+    model.setQuery(QStringLiteral("user0001"));
+    QCOMPARE(model.rowCount(), 50);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 100);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    // the daemon's list replaces the one there was
+    model.addUserPage(users(2).mid(0, 1), 2);
+    QCOMPARE(model.rowCount(), 100);
+    model.addUserPage(users(2).mid(1, 1), 2);
+    model.setQuery(QStringLiteral("user"));
+    QCOMPARE(model.rowCount(), 2);
+}
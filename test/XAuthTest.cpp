@@ -0,0 +1,159 @@
+/*
+ * Xauthority tests
+ * Copyright (C) 2026 SDDM contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "XAuthTest.h"
+#include "XAuth.h"
+
+#include <QtTest/QtTest>
+
+#include <unistd.h>
+
+using namespace SDDM;
+
+QTEST_MAIN(XAuthTest);
+
+static const QString COOKIE = QStringLiteral("00112233445566778899aabbccddeeff");
+
+static QByteArray hostName() {
+    char name[256] = { 0 };
+    gethostname(name, sizeof(name) - 1);
+    return QByteArray(name);
+}
+
+static QVector<XAuth::Entry> readFile(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QVector<XAuth::Entry>();
+    return XAuth::readEntries(file.readAll());
+}
+
+QString XAuthTest::authPath(const QString &name) const {
+    return m_dir.path() + QLatin1Char('/') + name;
+}
+
+void XAuthTest::RoundTrip() {
+    XAuth::Entry local;
+    local.family = 256;
+    local.address = "host";
+    local.number = "0";
+    local.name = "MIT-MAGIC-COOKIE-1";
+    local.data = QByteArray::fromHex(COOKIE.toLatin1());
+
+    XAuth::Entry wild;
+    wild.family = 0xffff;
+    wild.number = "12";
+    wild.name = "MIT-MAGIC-COOKIE-1";
+    wild.data = QByteArray(16, '\xff');
+
+    const QVector<XAuth::Entry> entries = XAuth::readEntries(XAuth::writeEntries({ local, wild }));
+    QCOMPARE(entries.size(), 2);
+    QCOMPARE(entries[0].family, quint16(256));
+    QCOMPARE(entries[0].address, QByteArray("host"));
+    QCOMPARE(entries[0].number, QByteArray("0"));
+    QCOMPARE(entries[0].name, QByteArray("MIT-MAGIC-COOKIE-1"));
+    QCOMPARE(entries[0].data, local.data);
+    QCOMPARE(entries[1].family, quint16(0xffff));
+    QVERIFY(entries[1].address.isEmpty());
+    QCOMPARE(entries[1].number, QByteArray("12"));
+    QCOMPARE(entries[1].data, wild.data);
+}
+
+void XAuthTest::Layout() {
+    const QString path = authPath(QStringLiteral("layout"));
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":5"), path, COOKIE));
+
+    // big endian counted strings, as written by XauWriteAuth()
+    const QByteArray host = hostName();
+    QByteArray expected;
+    expected += QByteArray::fromHex("0100");
+    expected += char(host.size() >> 8);
+    expected += char(host.size() & 0xff);
+    expected += host;
+    expected += QByteArray::fromHex("0001") + "5";
+    expected += QByteArray::fromHex("0012") + "MIT-MAGIC-COOKIE-1";
+    expected += QByteArray::fromHex("0010") + QByteArray::fromHex(COOKIE.toLatin1());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+    QCOMPARE(file.permissions() & (QFileDevice::ReadGroup | QFileDevice::ReadOther), QFileDevice::Permissions());
+}
+
+void XAuthTest::Replace() {
+    const QString path = authPath(QStringLiteral("replace"));
+    const QString other = QStringLiteral("ffeeddccbbaa99887766554433221100");
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":0"), path, other));
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":1"), path, other));
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":0.0"), path, COOKIE));
+
+    const QVector<XAuth::Entry> entries = readFile(path);
+    QCOMPARE(entries.size(), 2);
+    QCOMPARE(entries[0].number, QByteArray("1"));
+    QCOMPARE(entries[0].data, QByteArray::fromHex(other.toLatin1()));
+    QCOMPARE(entries[1].number, QByteArray("0"));
+    QCOMPARE(entries[1].data, QByteArray::fromHex(COOKIE.toLatin1()));
+}
+
+void XAuthTest::Truncated() {
+    const QString path = authPath(QStringLiteral("truncated"));
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":0"), path, COOKIE));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(QByteArray::fromHex("0100ff"));
+    file.close();
+
+    // what can be read is kept, the rest is dropped on the next write
+    QCOMPARE(readFile(path).size(), 1);
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":1"), path, COOKIE));
+    QCOMPARE(readFile(path).size(), 2);
+}
+
+void XAuthTest::Cookie() {
+    const QString first = XAuth::generateCookie();
+    const QString second = XAuth::generateCookie();
+
+    QCOMPARE(first.size(), 32);
+    QCOMPARE(QByteArray::fromHex(first.toLatin1()).size(), 16);
+    QVERIFY(first != second);
+}
+
+void XAuthTest::XauthList() {
+    const QString xauth = QStandardPaths::findExecutable(QStringLiteral("xauth"));
+    if (xauth.isEmpty())
+        QSKIP("xauth is not installed");
+
+    const QString path = authPath(QStringLiteral("list"));
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":0"), path, QStringLiteral("ffeeddccbbaa99887766554433221100")));
+    QVERIFY(XAuth::addCookieToFile(QStringLiteral(":7"), path, COOKIE));
+
+    QProcess process;
+    process.start(xauth, { QStringLiteral("-f"), path, QStringLiteral("list") });
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitCode(), 0);
+
+    const QStringList lines = QString::fromLocal8Bit(process.readAllStandardOutput()).split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    QCOMPARE(lines.size(), 2);
+    const QStringList fields = lines[1].simplified().split(QLatin1Char(' '));
+    QCOMPARE(fields.size(), 3);
+    QCOMPARE(fields[0], QString::fromLocal8Bit(hostName()) + QStringLiteral("/unix:7"));
+    QCOMPARE(fields[1], QStringLiteral("MIT-MAGIC-COOKIE-1"));
+    QCOMPARE(fields[2], COOKIE);
+}